@@ -0,0 +1,363 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+/*
+ * Benchmarks for the wrapper, run against the dummy adjustment
+ * method so that no display is needed. Each benchmark runs a
+ * number of warm-up iterations and then times each iteration
+ * separately, and reports percentiles of the latency and the
+ * number of memory allocations per iteration.
+ * 
+ * Usage: bench [-f json|csv] [-n iterations] [-w warmup]
+ */
+
+
+/**
+ * The number of calls to `malloc`, `calloc` and `realloc`,
+ * which includes `operator new`.
+ */
+static std::atomic<size_t> allocations(0);
+
+
+#if defined(__GLIBC__)
+extern "C"
+{
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void* ptr, size_t size);
+  
+  /**
+   * Count and forward allocations, this
+   * takes precedence over libc's `malloc`.
+   */
+  void* malloc(size_t size) throw()
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+  
+  /**
+   * Count and forward allocations, this
+   * takes precedence over libc's `calloc`.
+   */
+  void* calloc(size_t count, size_t size) throw()
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+  }
+  
+  /**
+   * Count and forward allocations, this
+   * takes precedence over libc's `realloc`.
+   */
+  void* realloc(void* ptr, size_t size) throw()
+  {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+  }
+}
+# define ALLOCATIONS_COUNTED  true
+#else
+# define ALLOCATIONS_COUNTED  false
+#endif
+
+
+/**
+ * The result of a benchmark.
+ */
+class Result
+{
+public:
+  /**
+   * Constructor.
+   * 
+   * @param  benchmark  The name of the benchmark.
+   */
+  Result(const char* benchmark) :
+    name(benchmark),
+    iterations(0),
+    latencies(),
+    allocations_per_iteration(0)
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  ~Result();
+  
+  /**
+   * The name of the benchmark.
+   */
+  std::string name;
+  
+  /**
+   * The number of timed iterations.
+   */
+  size_t iterations;
+  
+  /**
+   * The latencies, in nanoseconds, sorted.
+   */
+  std::vector<double> latencies;
+  
+  /**
+   * The mean number of allocations per iteration.
+   */
+  double allocations_per_iteration;
+  
+  /**
+   * Get a percentile of the latencies.
+   * 
+   * @param   p  The percentile, in [0, 100].
+   * @return     The latency, in nanoseconds.
+   */
+  double percentile(double p) const __attribute__((pure))
+  {
+    size_t i = (size_t)(p / 100 * (double)(this->latencies.size() - 1) + 0.5);
+    return this->latencies[i];
+  }
+  
+  /**
+   * Get the mean of the latencies.
+   * 
+   * @return  The mean latency, in nanoseconds.
+   */
+  double mean() const __attribute__((pure))
+  {
+    double sum = 0;
+    for (double latency : this->latencies)
+      sum += latency;
+    return sum / (double)(this->latencies.size());
+  }
+  
+};
+
+/**
+ * Destructor.
+ */
+Result::~Result()
+{
+  /* Do nothing. */
+}
+
+
+/**
+ * The number of timed iterations per benchmark.
+ */
+static size_t iterations = 10000;
+
+/**
+ * The number of untimed iterations per benchmark.
+ */
+static size_t warmup = 100;
+
+/**
+ * The results of the benchmarks that have run.
+ */
+static std::vector<Result*> results;
+
+
+/**
+ * Run a benchmark.
+ * 
+ * @param  name  The name of the benchmark.
+ * @param  f     The function to benchmark, it is called once per iteration.
+ */
+template <typename F>
+static void bench(const char* name, F f)
+{
+  Result* result = new Result(name);
+  size_t i, allocated;
+  result->iterations = iterations;
+  result->latencies.resize(iterations);
+  
+  for (i = 0; i < warmup; i++)
+    f();
+  
+  allocated = allocations.load();
+  for (i = 0; i < iterations; i++)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      auto end = std::chrono::steady_clock::now();
+      result->latencies[i] = std::chrono::duration<double, std::nano>(end - start).count();
+    }
+  /* Everything but the benchmarked code allocates nothing in the loop. */
+  allocated = allocations.load() - allocated;
+  result->allocations_per_iteration = (double)allocated / (double)iterations;
+  
+  std::sort(result->latencies.begin(), result->latencies.end());
+  results.push_back(result);
+}
+
+
+/**
+ * Print the results as JSON.
+ */
+static void print_json()
+{
+  size_t i;
+  std::cout << "{\"iterations\": " << iterations
+	    << ", \"allocations_counted\": " << (ALLOCATIONS_COUNTED ? "true" : "false")
+	    << ", \"benchmarks\": [" << std::endl;
+  for (i = 0; i < results.size(); i++)
+    {
+      const Result& r = *(results[i]);
+      std::cout << "  {\"name\": \"" << r.name << "\""
+		<< ", \"min_ns\": " << r.latencies.front()
+		<< ", \"p50_ns\": " << r.percentile(50)
+		<< ", \"p90_ns\": " << r.percentile(90)
+		<< ", \"p99_ns\": " << r.percentile(99)
+		<< ", \"max_ns\": " << r.latencies.back()
+		<< ", \"mean_ns\": " << r.mean()
+		<< ", \"allocations\": " << r.allocations_per_iteration
+		<< "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+  std::cout << "]}" << std::endl;
+}
+
+
+/**
+ * Print the results as CSV.
+ */
+static void print_csv()
+{
+  std::cout << "name,iterations,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns,allocations" << std::endl;
+  for (const Result* r : results)
+    std::cout << r->name << ","
+	      << r->iterations << ","
+	      << r->latencies.front() << ","
+	      << r->percentile(50) << ","
+	      << r->percentile(90) << ","
+	      << r->percentile(99) << ","
+	      << r->latencies.back() << ","
+	      << r->mean() << ","
+	      << r->allocations_per_iteration << std::endl;
+}
+
+
+#define BENCH_RAMPS(AFFIX, T)								\
+  bench("gamma_ramps" #AFFIX "_create", [&]						\
+	{										\
+	  delete libgamma::gamma_ramps ## AFFIX ## _create(size, size, size);		\
+	});										\
+  bench("gamma_ramps" #AFFIX "_initialise", [&]					\
+	{										\
+	  libgamma::GammaRamps<T> local;						\
+	  libgamma::gamma_ramps ## AFFIX ## _initialise(&local, size, size, size);	\
+	})
+
+
+int main(int argc, char* argv[])
+{
+  libgamma::Site* site;
+  libgamma::Partition* partition;
+  libgamma::CRTC* crtc;
+  libgamma::CRTCInformation info;
+  libgamma::GammaRamps<uint16_t>* ramps;
+  bool csv = false;
+  size_t size;
+  int i;
+  
+  for (i = 1; i < argc; i++)
+    if (!strcmp(argv[i], "-f") && (i + 1 < argc))
+      csv = !strcmp(argv[++i], "csv");
+    else if (!strcmp(argv[i], "-n") && (i + 1 < argc))
+      iterations = (size_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "-w") && (i + 1 < argc))
+      warmup = (size_t)atol(argv[++i]);
+    else
+      {
+	std::cerr << "Usage: " << argv[0] << " [-f json|csv] [-n iterations] [-w warmup]" << std::endl;
+	return 1;
+      }
+  if (iterations == 0)
+    iterations = 1;
+  
+  if (!libgamma::is_method_available(LIBGAMMA_METHOD_DUMMY))
+    {
+      std::cerr << argv[0] << ": the dummy adjustment method is not available" << std::endl;
+      return 1;
+    }
+  
+  site = new libgamma::Site(LIBGAMMA_METHOD_DUMMY);
+  partition = new libgamma::Partition(site, 0);
+  crtc = new libgamma::CRTC(partition, 0);
+  crtc->information(&info, LIBGAMMA_CRTC_INFO_GAMMA_SIZE);
+  size = info.red_gamma_size;
+  
+  BENCH_RAMPS(8, uint8_t);
+  BENCH_RAMPS(16, uint16_t);
+  BENCH_RAMPS(32, uint32_t);
+  BENCH_RAMPS(64, uint64_t);
+  BENCH_RAMPS(f, float);
+  BENCH_RAMPS(d, double);
+  
+  ramps = libgamma::gamma_ramps16_create(info.red_gamma_size, info.green_gamma_size, info.blue_gamma_size);
+  bench("CRTC::get_gamma", [&] { crtc->get_gamma(ramps); });
+  bench("CRTC::set_gamma", [&] { crtc->set_gamma(ramps); });
+  delete ramps;
+  
+  bench("CRTC::information", [&]
+	{
+	  libgamma::CRTCInformation information;
+	  crtc->information(&information, ~0);
+	});
+  
+  bench("list_methods", [] { libgamma::list_methods(0); });
+  
+  {
+    unsigned char edid[128];
+    std::string hex;
+    for (size = 0; size < sizeof(edid); size++)
+      edid[size] = (unsigned char)(size * 37);
+    hex = libgamma::behex_edid(edid, sizeof(edid));
+    bench("behex_edid", [&] { libgamma::behex_edid(edid, sizeof(edid)); });
+    bench("unhex_edid", [&] { free(libgamma::unhex_edid(hex)); });
+  }
+  
+  bench("create_error", [] { libgamma::create_error(LIBGAMMA_NO_SUCH_ADJUSTMENT_METHOD).what(); });
+  bench("name_of_error", [] { delete libgamma::name_of_error(LIBGAMMA_NO_SUCH_ADJUSTMENT_METHOD); });
+  bench("error_name", [] { libgamma::error_name(LIBGAMMA_NO_SUCH_ADJUSTMENT_METHOD); });
+  
+  delete crtc;
+  delete partition;
+  delete site;
+  
+  if (csv)
+    print_csv();
+  else
+    print_json();
+  for (Result* result : results)
+    delete result;
+  return 0;
+}
+
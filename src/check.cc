@@ -0,0 +1,367 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma.hh"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/*
+ * Checks of the parts of the library that do not need a display:
+ * decoding of EDID:s, conversion of EDID:s to and from hexadecimal
+ * representation, and saving and loading calibration caches.
+ * 
+ * Usage: check
+ */
+
+
+/**
+ * An EDID of a made-up monitor: manufacturer GSM, product
+ * code 0x1234, serial number 1, made in week 10 of 2020,
+ * EDID 1.4, gamma 2.2, sRGB primaries, no extension blocks.
+ */
+static const unsigned char edid[128] =
+  {
+    0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00,
+    0x1E, 0x6D, 0x34, 0x12, 0x01, 0x00, 0x00, 0x00,
+    0x0A, 0x1E, 0x01, 0x04, 0xB5, 0x3C, 0x22, 0x78,
+    0x0A, 0xEE, 0x91, 0xA3, 0x54, 0x4C, 0x99, 0x26,
+    0x0F, 0x50, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E
+  };
+
+/**
+ * The number of failed checks.
+ */
+static size_t failures = 0;
+
+
+/**
+ * Record the outcome of a check.
+ * 
+ * @param  ok    Whether the check passed.
+ * @param  what  Description of the failure.
+ */
+static void check(bool ok, const char* what)
+{
+  if (!ok)
+    {
+      std::cerr << "check: " << what << std::endl;
+      failures++;
+    }
+}
+
+
+/**
+ * Get the error a function throws.
+ * 
+ * @param   function  The function.
+ * @return            The error code of the `LibgammaException`
+ *                    the function threw, zero if it did not throw.
+ */
+static int error_of(const std::function<void()>& function)
+{
+  try
+    {
+      function();
+    }
+  catch (const libgamma::LibgammaException& e)
+    {
+      return e.error_code;
+    }
+  return 0;
+}
+
+
+/**
+ * Check whether a value decoded from an EDID is as expected,
+ * EDID:s store fractions with a precision of 1/1024.
+ * 
+ * @param   value     The decoded value.
+ * @param   expected  The expected value.
+ * @return            Whether the values are within 1/1024.
+ */
+static bool near(double value, double expected) __attribute__((const));
+static bool near(double value, double expected)
+{
+  return fabs(value - expected) < 1. / 1024.;
+}
+
+
+/**
+ * Fill gamma ramps with distinct values.
+ * 
+ * @param  ramps  The gamma ramps.
+ * @param  base   The value of the first stop.
+ * @param  step   The difference between adjacent stops.
+ */
+template <typename T>
+static void fill(libgamma::GammaRamps<T>* ramps, double base, double step)
+{
+  size_t i;
+  for (i = 0; i < ramps->red.size; i++)
+    ramps->red.ramp[i] = (T)(base + step * (double)i);
+  for (i = 0; i < ramps->green.size; i++)
+    ramps->green.ramp[i] = (T)(base + step * (double)(i + ramps->red.size));
+  for (i = 0; i < ramps->blue.size; i++)
+    ramps->blue.ramp[i] = (T)(base + step * (double)(i + ramps->red.size + ramps->green.size));
+}
+
+
+/**
+ * Check whether two gamma ramps are identical.
+ * 
+ * @param   a  One of the gamma ramps.
+ * @param   b  The other gamma ramps, with the same sizes as `a`.
+ * @return     Whether the gamma ramps are identical.
+ */
+template <typename T>
+static bool identical(const libgamma::GammaRamps<T>* a, const libgamma::GammaRamps<T>* b)
+{
+  return !memcmp(a->red.ramp, b->red.ramp, a->red.size * sizeof(T)) &&
+    !memcmp(a->green.ramp, b->green.ramp, a->green.size * sizeof(T)) &&
+    !memcmp(a->blue.ramp, b->blue.ramp, a->blue.size * sizeof(T));
+}
+
+
+/**
+ * Check the decoding of EDID:s.
+ */
+static void check_edid()
+{
+  libgamma::EdidView view(edid, sizeof(edid));
+  libgamma::EdidView short_view(edid, sizeof(edid) - 1);
+  libgamma::EdidChromaticity chromaticity;
+  unsigned char corrupt[sizeof(edid)];
+  char manufacturer[4];
+  
+  check(view.valid(), "valid EDID reported as invalid");
+  check(view.checksum_ok(0), "valid EDID reported with bad checksum");
+  check(view.checksums_ok(), "valid EDID reported with bad checksums");
+  view.manufacturer(manufacturer);
+  check(!strcmp(manufacturer, "GSM"), "wrong manufacturer decoded");
+  check(view.product_code() == 0x1234, "wrong product code decoded");
+  check(view.serial_number() == 1, "wrong serial number decoded");
+  check(view.manufacture_week() == 10, "wrong week of manufacture decoded");
+  check(view.manufacture_year() == 2020, "wrong year of manufacture decoded");
+  check((view.version() == 1) && (view.revision() == 4), "wrong EDID version decoded");
+  check(near(view.gamma(), 2.2), "wrong gamma decoded");
+  check(view.chromaticity(&chromaticity), "chromaticity not decoded");
+  check(near(chromaticity.red_x, 0.640) && near(chromaticity.red_y, 0.330),
+	"wrong red primary decoded");
+  check(near(chromaticity.green_x, 0.300) && near(chromaticity.green_y, 0.600),
+	"wrong green primary decoded");
+  check(near(chromaticity.blue_x, 0.150) && near(chromaticity.blue_y, 0.060),
+	"wrong blue primary decoded");
+  check(near(chromaticity.white_x, 0.3125) && near(chromaticity.white_y, 0.3291),
+	"wrong white point decoded");
+  check((view.extension_count() == 0) && (view.extension(0) == nullptr),
+	"extension block reported in EDID without extension blocks");
+  
+  memcpy(corrupt, edid, sizeof(edid));
+  corrupt[sizeof(edid) - 1] ^= 1;
+  libgamma::EdidView corrupt_view(corrupt, sizeof(corrupt));
+  check(!corrupt_view.valid(), "EDID with bad checksum reported as valid");
+  check(!corrupt_view.checksum_ok(0), "bad checksum reported as correct");
+  check(!corrupt_view.checksums_ok(), "bad checksums reported as correct");
+  
+  check(!short_view.valid(), "truncated EDID reported as valid");
+  check(!short_view.checksum_ok(0), "checksum of truncated EDID reported as correct");
+  short_view.manufacturer(manufacturer);
+  check(*manufacturer == '\0', "manufacturer decoded from truncated EDID");
+  check(near(short_view.gamma(), 0), "gamma decoded from truncated EDID");
+  check(!short_view.chromaticity(&chromaticity), "chromaticity decoded from truncated EDID");
+}
+
+
+/**
+ * Check the conversion of EDID:s to and
+ * from hexadecimal representation.
+ */
+static void check_hex()
+{
+  std::string lowercase = libgamma::behex_edid(edid, sizeof(edid));
+  std::string uppercase = libgamma::behex_edid_uppercase(edid, sizeof(edid));
+  std::string reused;
+  unsigned char raw[sizeof(edid)];
+  char buffer[2 * sizeof(edid) + 1];
+  
+  check((lowercase.size() == 2 * sizeof(edid)) && !lowercase.compare(0, 16, "00ffffffffffff00"),
+	"wrong lowercase hexadecimal representation");
+  check((uppercase.size() == 2 * sizeof(edid)) && !uppercase.compare(0, 16, "00FFFFFFFFFFFF00"),
+	"wrong uppercase hexadecimal representation");
+  check(libgamma::behex_edid_lowercase(edid, sizeof(edid)) == lowercase,
+	"behex_edid_lowercase differs from behex_edid");
+  check((libgamma::behex_edid(edid, sizeof(edid), buffer, sizeof(buffer), true) == 2 * sizeof(edid)) &&
+	(uppercase == buffer), "wrong hexadecimal representation in buffer");
+  libgamma::behex_edid(edid, sizeof(edid), &reused);
+  check(reused == lowercase, "wrong hexadecimal representation in string");
+  
+  check((libgamma::unhex_edid(lowercase, raw, sizeof(raw)) == sizeof(edid)) &&
+	!memcmp(raw, edid, sizeof(edid)), "lowercase hexadecimal representation not round-tripped");
+  check((libgamma::unhex_edid(uppercase, raw, sizeof(raw)) == sizeof(edid)) &&
+	!memcmp(raw, edid, sizeof(edid)), "uppercase hexadecimal representation not round-tripped");
+  check((libgamma::unhex_edid("aB", 2, raw, 1) == 1) && (*raw == 0xAB),
+	"mixed case hexadecimal representation not decoded");
+  
+  check(error_of([&]() { libgamma::unhex_edid("abc", 3, raw, sizeof(raw)); }) == EINVAL,
+	"odd length hexadecimal representation not rejected");
+  check(error_of([&]() { libgamma::unhex_edid("0g", 2, raw, sizeof(raw)); }) == EINVAL,
+	"invalid hexadecimal digit not rejected");
+  check(error_of([&]() { libgamma::unhex_edid(lowercase, raw, sizeof(raw) - 1); }) == ERANGE,
+	"too small buffer for raw representation not rejected");
+  check(error_of([&]() { libgamma::behex_edid(edid, sizeof(edid), buffer, sizeof(buffer) - 1); }) == ERANGE,
+	"too small buffer for hexadecimal representation not rejected");
+}
+
+
+/**
+ * Check saving and loading of a calibration cache.
+ * 
+ * @param  path  The file to save the cache to, it must not exist.
+ */
+static void check_calibration_file(const std::string& path)
+{
+  libgamma::CalibrationKey key(edid, sizeof(edid), 4, 5, 6, 16);
+  libgamma::CalibrationKey float_key(edid, sizeof(edid), 4, 5, 6, -1);
+  libgamma::GammaRamps<uint16_t> ramps, ramps_loaded;
+  libgamma::GammaRamps<float> rampsf, rampsf_loaded;
+  static const char garbage[10] = { 0 };
+  struct stat attr;
+  FILE* file;
+  
+  libgamma::gamma_ramps_allocate(&ramps, 4, 5, 6);
+  libgamma::gamma_ramps_allocate(&ramps_loaded, 4, 5, 6);
+  libgamma::gamma_ramps_allocate(&rampsf, 4, 5, 6);
+  libgamma::gamma_ramps_allocate(&rampsf_loaded, 4, 5, 6);
+  fill(&ramps, 1000, 300);
+  fill(&rampsf, 0.125, 0.25);
+  
+  {
+    libgamma::CalibrationCache cache(4, path);
+    check(!cache.load(), "missing calibration file reported as loaded");
+    cache.store(key, &ramps);
+    cache.store(float_key, &rampsf);
+    cache.save();
+  }
+  
+  libgamma::CalibrationCache cache(4, path);
+  check(cache.load(), "saved calibration file not found");
+  check(cache.size() == 2, "wrong number of calibrations loaded");
+  check(cache.lookup(key, &ramps_loaded) && identical(&ramps, &ramps_loaded),
+	"16-bit calibration not round-tripped");
+  check(cache.lookup(float_key, &rampsf_loaded) && identical(&rampsf, &rampsf_loaded),
+	"floating point calibration not round-tripped");
+  check(!cache.lookup(float_key, &ramps_loaded), "calibration looked up with the wrong type");
+  
+  if (stat(path.c_str(), &attr) < 0)
+    {
+      check(false, "could not stat calibration file");
+      return;
+    }
+  file = fopen(path.c_str(), "ab");
+  check((file != nullptr) && (fwrite(garbage, sizeof(garbage), 1, file) == 1) && !fclose(file),
+	"could not append to calibration file");
+  check(error_of([&]() { cache.load(); }) == EINVAL,
+	"calibration file with truncated trailing header not rejected");
+  check(truncate(path.c_str(), attr.st_size - 1) == 0, "could not truncate calibration file");
+  check(error_of([&]() { cache.load(); }) == EINVAL,
+	"calibration file with truncated gamma ramps not rejected");
+  check(truncate(path.c_str(), 4) == 0, "could not truncate calibration file");
+  check(error_of([&]() { cache.load(); }) == EINVAL,
+	"calibration file with truncated magic number not rejected");
+}
+
+
+/**
+ * Check saving and loading of calibration
+ * caches, in a temporary directory.
+ */
+static void check_calibration()
+{
+  const char* tmpdir = getenv("TMPDIR");
+  std::string directory = std::string(tmpdir == nullptr ? "/tmp" : tmpdir) + "/libgammamm-check.XXXXXX";
+  std::vector<char> directory_name(directory.c_str(), directory.c_str() + directory.size() + 1);
+  std::string path;
+  
+  if (mkdtemp(directory_name.data()) == nullptr)
+    {
+      perror("check: mkdtemp");
+      failures++;
+      return;
+    }
+  path = std::string(directory_name.data()) + "/calibration";
+  
+  try
+    {
+      check_calibration_file(path);
+    }
+  catch (const libgamma::LibgammaException& e)
+    {
+      libgamma::perror("check", e.error_code);
+      failures++;
+    }
+  
+  unlink(path.c_str());
+  rmdir(directory_name.data());
+}
+
+
+int main(int argc, char* argv[])
+{
+  if (argc > 1)
+    {
+      std::cerr << "Usage: " << argv[0] << std::endl;
+      return 1;
+    }
+  
+  try
+    {
+      check_edid();
+      check_hex();
+      check_calibration();
+    }
+  catch (const libgamma::LibgammaException& e)
+    {
+      libgamma::perror(argv[0], e.error_code);
+      failures++;
+    }
+  
+  std::cout << failures << " failures" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
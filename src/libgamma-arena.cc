@@ -0,0 +1,138 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-arena.hh"
+
+#include "libgamma-error.hh"
+
+#include <cstdlib>
+
+
+namespace libgamma
+{
+  /**
+   * Constructor.
+   * 
+   * @param  cache_limit  The maximum number of released blocks
+   *                      to keep for each block size.
+   */
+  RampArena::RampArena(size_t cache_limit) :
+    max_cached(cache_limit),
+    free_blocks(),
+    mutex()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   * 
+   * All blocks allocated from the arena must
+   * have been released before it is destroyed.
+   */
+  RampArena::~RampArena()
+  {
+    this->trim();
+  }
+  
+  /**
+   * Allocate a block.
+   * 
+   * @param   bytes  The size of the block, in bytes.
+   * @return         The block, aligned to `LIBGAMMA_ARENA_ALIGNMENT` bytes.
+   */
+  void* RampArena::allocate(size_t bytes)
+  {
+    void* block = nullptr;
+    int r;
+    bytes = RampArena::padded(bytes);
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      auto it = this->free_blocks.find(bytes);
+      if ((it != this->free_blocks.end()) && !(it->second.empty()))
+	{
+	  block = it->second.back();
+	  it->second.pop_back();
+	  return block;
+	}
+    }
+    r = posix_memalign(&block, LIBGAMMA_ARENA_ALIGNMENT, bytes == 0 ? LIBGAMMA_ARENA_ALIGNMENT : bytes);
+    if (r != 0)
+      __LIBGAMMA_THROW(r);
+    return block;
+  }
+  
+  /**
+   * Return a block to the arena.
+   * 
+   * @param  block  The block, may be `nullptr`.
+   * @param  bytes  The size the block was allocated with.
+   */
+  void RampArena::release(void* block, size_t bytes)
+  {
+    if (block == nullptr)
+      return;
+    bytes = RampArena::padded(bytes);
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+      try
+#endif
+	{
+	  std::vector<void*>& list = this->free_blocks[bytes];
+	  if (list.size() < this->max_cached)
+	    {
+	      list.push_back(block);
+	      return;
+	    }
+	}
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+      catch (...)
+	{
+	  /* Out of memory, free the block instead of keeping it. */
+	}
+#endif
+    }
+    free(block);
+  }
+  
+  /**
+   * Free all blocks that are kept for reuse.
+   */
+  void RampArena::trim()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto& entry : this->free_blocks)
+      for (void* block : entry.second)
+	free(block);
+    this->free_blocks.clear();
+  }
+  
+  /**
+   * Get the arena that is used when no arena is specified.
+   * It is never destroyed.
+   * 
+   * @return  The shared arena.
+   */
+  RampArena* RampArena::shared()
+  {
+    static RampArena* arena = new RampArena();
+    return arena;
+  }
+  
+}
+
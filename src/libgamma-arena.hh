@@ -0,0 +1,150 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_ARENA_HH
+#define LIBGAMMA_ARENA_HH
+
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+/**
+ * The alignment of blocks allocated by a `RampArena`,
+ * and of each channel in such blocks, a cache line.
+ */
+#define LIBGAMMA_ARENA_ALIGNMENT  64
+
+
+
+namespace libgamma
+{
+  /**
+   * A pool of cache line aligned memory blocks for gamma ramps.
+   * 
+   * Released blocks are kept in a free list for their size,
+   * so allocating gamma ramps of a size that has been used
+   * before does not call `malloc` or `free`. The arena is
+   * thread-safe.
+   */
+  class RampArena
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  cache_limit  The maximum number of released blocks
+     *                      to keep for each block size.
+     */
+    RampArena(size_t cache_limit = 16);
+    
+    /**
+     * Destructor.
+     * 
+     * All blocks allocated from the arena must
+     * have been released before it is destroyed.
+     */
+    ~RampArena();
+    
+    /**
+     * Allocate a block.
+     * 
+     * @param   bytes  The size of the block, in bytes.
+     * @return         The block, aligned to `LIBGAMMA_ARENA_ALIGNMENT` bytes.
+     */
+    void* allocate(size_t bytes);
+    
+    /**
+     * Return a block to the arena.
+     * 
+     * @param  block  The block, may be `nullptr`.
+     * @param  bytes  The size the block was allocated with.
+     */
+    void release(void* block, size_t bytes);
+    
+    /**
+     * Free all blocks that are kept for reuse.
+     */
+    void trim();
+    
+    /**
+     * Get the number of bytes a channel takes up in a block.
+     * 
+     * @param   bytes  The size of the channel's ramp, in bytes.
+     * @return         `bytes` rounded up to a multiple of `LIBGAMMA_ARENA_ALIGNMENT`.
+     */
+    static size_t padded(size_t bytes) __attribute__((const))
+    {
+      return (bytes + (LIBGAMMA_ARENA_ALIGNMENT - 1)) & ~(size_t)(LIBGAMMA_ARENA_ALIGNMENT - 1);
+    }
+    
+    /**
+     * Get the arena that is used when no arena is specified.
+     * It is never destroyed.
+     * 
+     * @return  The shared arena.
+     */
+    static RampArena* shared();
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    RampArena(const RampArena&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    RampArena& operator =(const RampArena&) = delete;
+    
+    
+    
+    /**
+     * The maximum number of released blocks
+     * to keep for each block size.
+     */
+    size_t max_cached;
+    
+    /**
+     * Released blocks, by their size.
+     */
+    std::unordered_map<size_t, std::vector<void*>> free_blocks;
+    
+    /**
+     * Guards `free_blocks`.
+     */
+    std::mutex mutex;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
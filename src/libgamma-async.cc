@@ -0,0 +1,164 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-async.hh"
+
+#include "libgamma-batch.hh"
+
+#include <cerrno>
+#include <memory>
+#include <new>
+
+
+namespace libgamma
+{
+  /**
+   * Run an operation on a CRTC in the CRTC's serial queue,
+   * and make a future for its completion.
+   * 
+   * @param   crtc       The CRTC.
+   * @param   operation  The operation, may throw.
+   * @param   pool       The worker pool to use, `nullptr` for the shared pool.
+   * @return             The future for the operation.
+   */
+  static std::future<void> submit_future(CRTC* crtc, std::function<void()> operation, WorkerPool* pool)
+  {
+    std::shared_ptr<std::packaged_task<void()>> task = std::make_shared<std::packaged_task<void()>>(operation);
+    std::future<void> future = task->get_future();
+    if (pool == nullptr)
+      pool = WorkerPool::shared();
+    pool->submit(crtc_queue_key(crtc), std::bind(&std::packaged_task<void()>::operator(), task));
+    return future;
+  }
+  
+  /**
+   * Run an operation on a CRTC in the CRTC's serial
+   * queue, and call a function when it has completed.
+   * 
+   * @param  crtc       The CRTC.
+   * @param  operation  The operation, may throw.
+   * @param  callback   Called with zero on success, and otherwise the error code.
+   * @param  pool       The worker pool to use, `nullptr` for the shared pool.
+   */
+  static void submit_callback(CRTC* crtc, std::function<void()> operation,
+			      std::function<void(int)> callback, WorkerPool* pool)
+  {
+    if (pool == nullptr)
+      pool = WorkerPool::shared();
+    pool->submit(crtc_queue_key(crtc), [operation, callback]
+		 {
+		   int error = 0;
+		   try
+		     {
+		       operation();
+		     }
+		   catch (const LibgammaException& e)
+		     {
+		       error = e.error_code;
+		     }
+		   catch (const std::bad_alloc&)
+		     {
+		       error = ENOMEM;
+		     }
+		   if (callback)
+		     callback(error);
+		 });
+  }
+  
+  
+  /**
+   * Set the gamma ramps of a CRTC without waiting.
+   * 
+   * @param   crtc   The CRTC.
+   * @param   ramps  The gamma ramps to apply.
+   * @param   pool   The worker pool to use, `nullptr` for the shared pool.
+   * @return         A future that becomes ready when the gamma ramps have been
+   *                 applied, and that rethrows the error if they could not be.
+   */
+  template <typename T>
+  std::future<void> set_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, WorkerPool* pool)
+  {
+    return submit_future(crtc, [crtc, ramps] { crtc->set_gamma(ramps); }, pool);
+  }
+  
+  /**
+   * Get the current gamma ramps of a CRTC without waiting.
+   * 
+   * @param   crtc   The CRTC.
+   * @param   ramps  The gamma ramps to fill with the current values.
+   * @param   pool   The worker pool to use, `nullptr` for the shared pool.
+   * @return         A future that becomes ready when the gamma ramps have been
+   *                 filled, and that rethrows the error if they could not be.
+   */
+  template <typename T>
+  std::future<void> get_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, WorkerPool* pool)
+  {
+    return submit_future(crtc, [crtc, ramps] { crtc->get_gamma(ramps); }, pool);
+  }
+  
+  /**
+   * Set the gamma ramps of a CRTC without waiting.
+   * 
+   * @param  crtc      The CRTC.
+   * @param  ramps     The gamma ramps to apply.
+   * @param  callback  Called on a worker thread when the operation has completed,
+   *                   with zero on success and otherwise the error code, it must
+   *                   not throw exceptions.
+   * @param  pool      The worker pool to use, `nullptr` for the shared pool.
+   */
+  template <typename T>
+  void set_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, std::function<void(int)> callback, WorkerPool* pool)
+  {
+    submit_callback(crtc, [crtc, ramps] { crtc->set_gamma(ramps); }, callback, pool);
+  }
+  
+  /**
+   * Get the current gamma ramps of a CRTC without waiting.
+   * 
+   * @param  crtc      The CRTC.
+   * @param  ramps     The gamma ramps to fill with the current values.
+   * @param  callback  Called on a worker thread when the operation has completed,
+   *                   with zero on success and otherwise the error code, it must
+   *                   not throw exceptions.
+   * @param  pool      The worker pool to use, `nullptr` for the shared pool.
+   */
+  template <typename T>
+  void get_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, std::function<void(int)> callback, WorkerPool* pool)
+  {
+    submit_callback(crtc, [crtc, ramps] { crtc->get_gamma(ramps); }, callback, pool);
+  }
+  
+  
+#define __LIBGAMMA_ASYNC(T)											\
+  template std::future<void> set_gamma_async<T>(CRTC* crtc, GammaRamps<T>* ramps, WorkerPool* pool);		\
+  template std::future<void> get_gamma_async<T>(CRTC* crtc, GammaRamps<T>* ramps, WorkerPool* pool);		\
+  template void set_gamma_async<T>(CRTC* crtc, GammaRamps<T>* ramps, std::function<void(int)> callback,	\
+				   WorkerPool* pool);							\
+  template void get_gamma_async<T>(CRTC* crtc, GammaRamps<T>* ramps, std::function<void(int)> callback,	\
+				   WorkerPool* pool)
+  
+  __LIBGAMMA_ASYNC(uint8_t);
+  __LIBGAMMA_ASYNC(uint16_t);
+  __LIBGAMMA_ASYNC(uint32_t);
+  __LIBGAMMA_ASYNC(uint64_t);
+  __LIBGAMMA_ASYNC(float);
+  __LIBGAMMA_ASYNC(double);
+  
+#undef __LIBGAMMA_ASYNC
+
+}
+
@@ -0,0 +1,106 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_ASYNC_HH
+#define LIBGAMMA_ASYNC_HH
+
+
+#include <functional>
+#include <future>
+
+#include "libgamma-method.hh"
+#include "libgamma-executor.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /*
+   * The functions below run `CRTC::set_gamma` or `CRTC::get_gamma`
+   * on a worker pool, in the serial queue given by `crtc_queue_key`,
+   * so that operations on the same CRTC are performed in the order
+   * they were requested. The CRTC and the gamma ramps must remain
+   * valid, and the ramps must not be modified, until the operation
+   * has completed.
+   */
+  
+  /**
+   * Set the gamma ramps of a CRTC without waiting.
+   * 
+   * @param   crtc   The CRTC.
+   * @param   ramps  The gamma ramps to apply.
+   * @param   pool   The worker pool to use, `nullptr` for the shared pool.
+   * @return         A future that becomes ready when the gamma ramps have been
+   *                 applied, and that rethrows the error if they could not be.
+   */
+  template <typename T>
+  std::future<void> set_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, WorkerPool* pool = nullptr);
+  
+  /**
+   * Get the current gamma ramps of a CRTC without waiting.
+   * 
+   * @param   crtc   The CRTC.
+   * @param   ramps  The gamma ramps to fill with the current values.
+   * @param   pool   The worker pool to use, `nullptr` for the shared pool.
+   * @return         A future that becomes ready when the gamma ramps have been
+   *                 filled, and that rethrows the error if they could not be.
+   */
+  template <typename T>
+  std::future<void> get_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, WorkerPool* pool = nullptr);
+  
+  /**
+   * Set the gamma ramps of a CRTC without waiting.
+   * 
+   * @param  crtc      The CRTC.
+   * @param  ramps     The gamma ramps to apply.
+   * @param  callback  Called on a worker thread when the operation has completed,
+   *                   with zero on success and otherwise the error code, it must
+   *                   not throw exceptions.
+   * @param  pool      The worker pool to use, `nullptr` for the shared pool.
+   */
+  template <typename T>
+  void set_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, std::function<void(int)> callback,
+		       WorkerPool* pool = nullptr);
+  
+  /**
+   * Get the current gamma ramps of a CRTC without waiting.
+   * 
+   * @param  crtc      The CRTC.
+   * @param  ramps     The gamma ramps to fill with the current values.
+   * @param  callback  Called on a worker thread when the operation has completed,
+   *                   with zero on success and otherwise the error code, it must
+   *                   not throw exceptions.
+   * @param  pool      The worker pool to use, `nullptr` for the shared pool.
+   */
+  template <typename T>
+  void get_gamma_async(CRTC* crtc, GammaRamps<T>* ramps, std::function<void(int)> callback,
+		       WorkerPool* pool = nullptr);
+		       
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,130 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-batch.hh"
+
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+
+
+namespace libgamma
+{
+  /**
+   * Get the key of the serial queue that operations on a CRTC
+   * shall run in, so that operations that the adjustment method
+   * cannot perform in parallel are not run in parallel. This is
+   * the CRTC's partition if the adjustment method's partitions
+   * are graphics cards, and otherwise the CRTC's site.
+   * 
+   * @param   crtc  The CRTC.
+   * @return        The key for `WorkerPool::submit`.
+   */
+  const void* crtc_queue_key(const CRTC* crtc)
+  {
+    return partition_queue_key(crtc->partition);
+  }
+  
+  /**
+   * Get the key of the serial queue that operations on a
+   * partition, and on its CRTC:s, shall run in. This is the
+   * partition if the adjustment method's partitions are
+   * graphics cards, and otherwise the partition's site.
+   * 
+   * @param   partition  The partition.
+   * @return             The key for `WorkerPool::submit`.
+   */
+  const void* partition_queue_key(const Partition* partition)
+  {
+    if (partition->serial == &(partition->mutex))
+      return partition;
+    return partition->site;
+  }
+  
+  /**
+   * Set the gamma ramps of multiple CRTC:s in parallel. CRTC:s
+   * on different partitions, if the adjustment method's partitions
+   * are graphics cards, or else on different sites, are updated
+   * in parallel, and CRTC:s that share a partition or site are
+   * updated in order. This function returns when all CRTC:s have
+   * been updated. An error does not stop the other updates.
+   * 
+   * @param   updates  The CRTC:s and the gamma ramps to apply to them.
+   * @param   pool     The worker pool to use, `nullptr` for the shared pool.
+   * @return           For each update, zero on success, otherwise the
+   *                   error code that `CRTC::set_gamma` threw.
+   */
+  template <typename T>
+  std::vector<int> set_gamma_parallel(const std::vector<std::pair<CRTC*, GammaRamps<T>*>>& updates,
+				      WorkerPool* pool)
+  {
+    std::vector<int> errors(updates.size(), 0);
+    size_t remaining = updates.size();
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t i;
+    
+    if (pool == nullptr)
+      pool = WorkerPool::shared();
+    
+    for (i = 0; i < updates.size(); i++)
+      {
+	CRTC* crtc = updates[i].first;
+	GammaRamps<T>* ramps = updates[i].second;
+	int* error = &(errors[i]);
+	pool->submit(crtc_queue_key(crtc), [crtc, ramps, error, &remaining, &mutex, &condition]
+		     {
+		       try
+			 {
+			   crtc->set_gamma(ramps);
+			 }
+		       catch (const LibgammaException& e)
+			 {
+			   *error = e.error_code;
+			 }
+		       catch (const std::bad_alloc&)
+			 {
+			   *error = ENOMEM;
+			 }
+		       std::lock_guard<std::mutex> lock(mutex);
+		       if (--remaining == 0)
+			 condition.notify_all();
+		     });
+      }
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&remaining] { return remaining == 0; });
+    return errors;
+  }
+  
+  
+#define __LIBGAMMA_BATCH(T)									\
+  template std::vector<int> set_gamma_parallel<T>(const std::vector<std::pair<CRTC*, GammaRamps<T>*>>& updates,	\
+						  WorkerPool* pool)
+  
+  __LIBGAMMA_BATCH(uint8_t);
+  __LIBGAMMA_BATCH(uint16_t);
+  __LIBGAMMA_BATCH(uint32_t);
+  __LIBGAMMA_BATCH(uint64_t);
+  __LIBGAMMA_BATCH(float);
+  __LIBGAMMA_BATCH(double);
+  
+#undef __LIBGAMMA_BATCH
+
+}
+
@@ -0,0 +1,85 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_BATCH_HH
+#define LIBGAMMA_BATCH_HH
+
+
+#include <utility>
+#include <vector>
+
+#include "libgamma-method.hh"
+#include "libgamma-executor.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * Get the key of the serial queue that operations on a CRTC
+   * shall run in, so that operations that the adjustment method
+   * cannot perform in parallel are not run in parallel. This is
+   * the CRTC's partition if the adjustment method's partitions
+   * are graphics cards, and otherwise the CRTC's site.
+   * 
+   * @param   crtc  The CRTC.
+   * @return        The key for `WorkerPool::submit`.
+   */
+  const void* crtc_queue_key(const CRTC* crtc) __attribute__((pure));
+  
+  /**
+   * Get the key of the serial queue that operations on a
+   * partition, and on its CRTC:s, shall run in. This is the
+   * partition if the adjustment method's partitions are
+   * graphics cards, and otherwise the partition's site.
+   * 
+   * @param   partition  The partition.
+   * @return             The key for `WorkerPool::submit`.
+   */
+  const void* partition_queue_key(const Partition* partition) __attribute__((pure));
+  
+  /**
+   * Set the gamma ramps of multiple CRTC:s in parallel. CRTC:s
+   * on different partitions, if the adjustment method's partitions
+   * are graphics cards, or else on different sites, are updated
+   * in parallel, and CRTC:s that share a partition or site are
+   * updated in order. This function returns when all CRTC:s have
+   * been updated. An error does not stop the other updates.
+   * 
+   * @param   updates  The CRTC:s and the gamma ramps to apply to them.
+   * @param   pool     The worker pool to use, `nullptr` for the shared pool.
+   * @return           For each update, zero on success, otherwise the
+   *                   error code that `CRTC::set_gamma` threw.
+   */
+  template <typename T>
+  std::vector<int> set_gamma_parallel(const std::vector<std::pair<CRTC*, GammaRamps<T>*>>& updates,
+				      WorkerPool* pool = nullptr);
+				      
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
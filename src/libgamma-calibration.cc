@@ -0,0 +1,530 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-calibration.hh"
+
+#include "libgamma-error.hh"
+#include "libgamma-hash.hh"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+
+/**
+ * The first bytes of a calibration cache file.
+ */
+#define LIBGAMMA_CALIBRATION_MAGIC  "LGMMCAL\001"
+
+/**
+ * The largest gamma ramp size accepted when loading a
+ * calibration cache file, to reject corrupt files.
+ */
+#define LIBGAMMA_CALIBRATION_MAX_SIZE  (1 << 20)
+
+
+namespace libgamma
+{
+  /**
+   * A cached calibration.
+   */
+  class CalibrationEntry
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  entry_key      The key.
+     * @param  element_depth  The depth of the element type of the gamma ramps.
+     * @param  element_size   The size of the element type of the gamma ramps.
+     */
+    CalibrationEntry(const CalibrationKey& entry_key, signed element_depth, size_t element_size) :
+      key(entry_key),
+      depth(element_depth),
+      bytes((entry_key.red_size + entry_key.green_size + entry_key.blue_size) * element_size),
+      data((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+    {
+      /* Do nothing. */
+    }
+    
+    
+    
+    /**
+     * The key.
+     */
+    CalibrationKey key;
+    
+    /**
+     * The depth of the element type of the gamma ramps.
+     */
+    signed depth;
+    
+    /**
+     * The size of the gamma ramps, in bytes.
+     */
+    size_t bytes;
+    
+    /**
+     * The red, green and blue gamma ramps, one after the other,
+     * stored in words so that every element type is aligned.
+     */
+    std::vector<uint64_t> data;
+    
+  };
+  
+  
+  /**
+   * Get the size of the element type of gamma ramps with a specific depth.
+   * 
+   * @param   depth  The depth, as in `GammaRamps::depth`.
+   * @return         The size of the element type, zero if `depth` is invalid.
+   */
+  static size_t element_size(int64_t depth)
+  {
+    switch (depth)
+      {
+      case 8:   return sizeof(uint8_t);
+      case 16:  return sizeof(uint16_t);
+      case 32:  return sizeof(uint32_t);
+      case 64:  return sizeof(uint64_t);
+      case -1:  return sizeof(float);
+      case -2:  return sizeof(double);
+      default:  return 0;
+      }
+  }
+  
+  
+  /**
+   * Constructor, creates a key that matches nothing stored.
+   */
+  CalibrationKey::CalibrationKey() :
+    edid_hash(0), red_size(0), green_size(0), blue_size(0), depth(0)
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Constructor.
+   * 
+   * @param  edid         The monitor's EDID in raw representation.
+   * @param  edid_length  The length of `edid`.
+   * @param  red          The size of the red gamma ramp.
+   * @param  green        The size of the green gamma ramp.
+   * @param  blue         The size of the blue gamma ramp.
+   * @param  gamma_depth  The gamma depth of the CRTC.
+   */
+  CalibrationKey::CalibrationKey(const unsigned char* edid, size_t edid_length,
+				 size_t red, size_t green, size_t blue, signed gamma_depth) :
+    edid_hash(edid == nullptr ? 0 : hash_bytes(edid, edid_length)),
+    red_size(red), green_size(green), blue_size(blue), depth(gamma_depth)
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Constructor.
+   * 
+   * @param  info  Information about the CRTC, `edid`, `edid_length`,
+   *               `red_gamma_size`, `green_gamma_size`, `blue_gamma_size`
+   *               and `gamma_depth` must have been read.
+   */
+  CalibrationKey::CalibrationKey(const CRTCInformation& info) :
+    edid_hash(info.edid == nullptr ? 0 : hash_bytes(info.edid, info.edid_length)),
+    red_size(info.red_gamma_size), green_size(info.green_gamma_size),
+    blue_size(info.blue_gamma_size), depth(info.gamma_depth)
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Compare with another key.
+   * 
+   * @param   other  The other key.
+   * @return         Whether the keys are equal.
+   */
+  bool CalibrationKey::operator ==(const CalibrationKey& other) const
+  {
+    return (this->edid_hash == other.edid_hash) && (this->depth == other.depth)
+      && (this->red_size == other.red_size) && (this->green_size == other.green_size)
+      && (this->blue_size == other.blue_size);
+  }
+  
+  /**
+   * Hash a key.
+   * 
+   * @param   key  The key.
+   * @return       The hash of the key.
+   */
+  size_t CalibrationKeyHash::operator ()(const CalibrationKey& key) const
+  {
+    uint64_t sizes[4] = { key.red_size, key.green_size, key.blue_size, (uint64_t)(int64_t)(key.depth) };
+    return hash_bytes(sizes, sizeof(sizes), key.edid_hash);
+  }
+  
+  
+  /**
+   * Constructor.
+   * 
+   * @param  max_entries  The maximum number of cached calibrations.
+   * @param  file         The file used by `load` and `save`, empty for none.
+   */
+  CalibrationCache::CalibrationCache(size_t max_entries, const std::string& file) :
+    capacity(max_entries),
+    path(file),
+    hits(0),
+    misses(0),
+    recency(),
+    entries(),
+    mutex()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  CalibrationCache::~CalibrationCache()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Find a calibration and mark it as the most recently used.
+   * 
+   * @param   key    The key.
+   * @param   depth  The element depth the calibration must have been stored with.
+   * @return         The calibration, `nullptr` if not found.
+   */
+  std::shared_ptr<CalibrationEntry> CalibrationCache::find(const CalibrationKey& key, signed depth)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->entries.find(key);
+    if ((it == this->entries.end()) || ((*(it->second))->depth != depth))
+      {
+	this->misses++;
+	return nullptr;
+      }
+    this->recency.splice(this->recency.begin(), this->recency, it->second);
+    this->hits++;
+    return *(it->second);
+  }
+  
+  /**
+   * Insert a calibration as the most recently used,
+   * and evict calibrations if the cache is over capacity.
+   * 
+   * @param  entry  The calibration.
+   */
+  void CalibrationCache::insert(std::shared_ptr<CalibrationEntry> entry)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->entries.find(entry->key);
+    if (it != this->entries.end())
+      {
+	this->recency.erase(it->second);
+	this->entries.erase(it);
+      }
+    this->recency.push_front(entry);
+    this->entries[entry->key] = this->recency.begin();
+    while (this->recency.size() > this->capacity)
+      {
+	this->entries.erase(this->recency.back()->key);
+	this->recency.pop_back();
+      }
+  }
+  
+  /**
+   * Store a calibration, replacing any previous calibration
+   * with the same key. The gamma ramps are copied.
+   * 
+   * @param  key    The key.
+   * @param  ramps  The calibrated gamma ramps, their sizes should
+   *                match those in the key.
+   */
+  template <typename T>
+  void CalibrationCache::store(const CalibrationKey& key, const GammaRamps<T>* ramps)
+  {
+    std::shared_ptr<CalibrationEntry> entry;
+    signed depth = RampDepth<T>::value;
+    T* data;
+    if ((ramps->red.size != key.red_size) || (ramps->green.size != key.green_size) ||
+	(ramps->blue.size != key.blue_size))
+      throw create_error(EINVAL);
+    entry = std::make_shared<CalibrationEntry>(key, depth, sizeof(T));
+    data = (T*)(entry->data.data());
+    memcpy(data, ramps->red.ramp, key.red_size * sizeof(T));
+    memcpy(data + key.red_size, ramps->green.ramp, key.green_size * sizeof(T));
+    memcpy(data + key.red_size + key.green_size, ramps->blue.ramp, key.blue_size * sizeof(T));
+    this->insert(entry);
+  }
+  
+  /**
+   * Look up a calibration and copy it into gamma ramps.
+   * 
+   * @param   key    The key.
+   * @param   ramps  Gamma ramps, with the sizes in the key, to fill.
+   * @return         Whether the calibration was cached with
+   *                 the same element type as `ramps`.
+   */
+  template <typename T>
+  bool CalibrationCache::lookup(const CalibrationKey& key, GammaRamps<T>* ramps)
+  {
+    std::shared_ptr<CalibrationEntry> entry;
+    const T* data;
+    if ((ramps->red.size != key.red_size) || (ramps->green.size != key.green_size) ||
+	(ramps->blue.size != key.blue_size))
+      throw create_error(EINVAL);
+    entry = this->find(key, RampDepth<T>::value);
+    if (entry == nullptr)
+      return false;
+    data = (const T*)(entry->data.data());
+    memcpy(ramps->red.ramp, data, key.red_size * sizeof(T));
+    memcpy(ramps->green.ramp, data + key.red_size, key.green_size * sizeof(T));
+    memcpy(ramps->blue.ramp, data + key.red_size + key.green_size, key.blue_size * sizeof(T));
+    return true;
+  }
+  
+  /**
+   * Look up a calibration and apply it to a CRTC,
+   * directly from the cache without copying it.
+   * 
+   * @param   key   The key.
+   * @param   crtc  The CRTC.
+   * @return        Whether the calibration was cached with the
+   *                element type `T`, and thus was applied.
+   */
+  template <typename T>
+  bool CalibrationCache::apply(const CalibrationKey& key, CRTC* crtc)
+  {
+    /* The entry is kept alive by `entry` even if it is evicted meanwhile. */
+    std::shared_ptr<CalibrationEntry> entry = this->find(key, RampDepth<T>::value);
+    T* data;
+    if (entry == nullptr)
+      return false;
+    data = (T*)(entry->data.data());
+    GammaRamps<T> ramps = GammaRamps<T>::view(data, data + key.red_size, data + key.red_size + key.green_size,
+					      key.red_size, key.green_size, key.blue_size);
+    crtc->set_gamma(&ramps);
+    return true;
+  }
+  
+  /**
+   * Remove a calibration.
+   * 
+   * @param   key  The key.
+   * @return       Whether the calibration was cached.
+   */
+  bool CalibrationCache::erase(const CalibrationKey& key)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->entries.find(key);
+    if (it == this->entries.end())
+      return false;
+    this->recency.erase(it->second);
+    this->entries.erase(it);
+    return true;
+  }
+  
+  /**
+   * Remove all calibrations.
+   */
+  void CalibrationCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+    this->recency.clear();
+  }
+  
+  /**
+   * Get the number of cached calibrations.
+   * 
+   * @return  The number of cached calibrations.
+   */
+  size_t CalibrationCache::size() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->recency.size();
+  }
+  
+  /**
+   * Load calibrations from `path`, in addition to those already
+   * cached. `EINVAL` is thrown if the file is malformed or
+   * truncated.
+   * 
+   * @return  Whether the file existed.
+   */
+  bool CalibrationCache::load()
+  {
+    char magic[sizeof(LIBGAMMA_CALIBRATION_MAGIC) - 1];
+    std::shared_ptr<CalibrationEntry> entry;
+    CalibrationKey key;
+    uint64_t header[6];
+    size_t size, n;
+    int saved_errno;
+    FILE* file;
+    
+    if (this->path.empty())
+      throw create_error(EINVAL);
+    file = fopen(this->path.c_str(), "rb");
+    if (file == nullptr)
+      {
+	if (errno == ENOENT)
+	  return false;
+	throw create_error(errno);
+      }
+    
+    if ((fread(magic, sizeof(magic), 1, file) != 1) ||
+	memcmp(magic, LIBGAMMA_CALIBRATION_MAGIC, sizeof(magic)))
+      goto invalid;
+    
+    /* Each calibration is stored as its EDID hash, its ramp sizes, its CRTC
+     * depth and its element depth as 64-bit integers, followed by its ramps.
+     * The file must end where a calibration ends. */
+    for (;;)
+      {
+	n = fread(header, 1, sizeof(header), file);
+	if ((n == 0) && feof(file))
+	  break;
+	if (n != sizeof(header))
+	  goto invalid;
+	if ((header[1] > LIBGAMMA_CALIBRATION_MAX_SIZE) ||
+	    (header[2] > LIBGAMMA_CALIBRATION_MAX_SIZE) ||
+	    (header[3] > LIBGAMMA_CALIBRATION_MAX_SIZE))
+	  goto invalid;
+	size = element_size((int64_t)(header[5]));
+	if (size == 0)
+	  goto invalid;
+	key.edid_hash = header[0];
+	key.red_size = header[1];
+	key.green_size = header[2];
+	key.blue_size = header[3];
+	key.depth = (signed)(int64_t)(header[4]);
+	entry = std::make_shared<CalibrationEntry>(key, (signed)(int64_t)(header[5]), size);
+	if ((entry->bytes > 0) && (fread(entry->data.data(), entry->bytes, 1, file) != 1))
+	  goto invalid;
+	this->insert(entry);
+      }
+    
+    fclose(file);
+    return true;
+  
+  invalid:
+    saved_errno = ferror(file) ? errno : EINVAL;
+    fclose(file);
+    throw create_error(saved_errno);
+  }
+  
+  /**
+   * Save the calibrations to `path`. The file is
+   * replaced atomically by writing a uniquely named
+   * temporary file next to it and renaming it, so
+   * concurrent saves do not interfere, the last
+   * rename wins. The file is only readable and
+   * writable by its owner.
+   */
+  void CalibrationCache::save() const
+  {
+    std::vector<std::shared_ptr<CalibrationEntry>> snapshot;
+    std::vector<char> temporary_name;
+    std::string temporary;
+    uint64_t header[6];
+    int saved_errno;
+    FILE* file;
+    int fd;
+    
+    if (this->path.empty())
+      throw create_error(EINVAL);
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      snapshot.assign(this->recency.rbegin(), this->recency.rend());
+    }
+    
+    temporary = this->path + ".XXXXXX";
+    temporary_name.assign(temporary.c_str(), temporary.c_str() + temporary.size() + 1);
+    fd = mkstemp(temporary_name.data());
+    if (fd < 0)
+      throw create_error(errno);
+    temporary = temporary_name.data();
+    file = fdopen(fd, "wb");
+    if (file == nullptr)
+      {
+	saved_errno = errno;
+	close(fd);
+	remove(temporary.c_str());
+	throw create_error(saved_errno);
+      }
+    
+    if (fwrite(LIBGAMMA_CALIBRATION_MAGIC, sizeof(LIBGAMMA_CALIBRATION_MAGIC) - 1, 1, file) != 1)
+      goto fail;
+    /* The least recently used is written first, so that
+     * `load` restores the order of use. */
+    for (const std::shared_ptr<CalibrationEntry>& entry : snapshot)
+      {
+	header[0] = entry->key.edid_hash;
+	header[1] = entry->key.red_size;
+	header[2] = entry->key.green_size;
+	header[3] = entry->key.blue_size;
+	header[4] = (uint64_t)(int64_t)(entry->key.depth);
+	header[5] = (uint64_t)(int64_t)(entry->depth);
+	if (fwrite(header, sizeof(header), 1, file) != 1)
+	  goto fail;
+	if ((entry->bytes > 0) && (fwrite(entry->data.data(), entry->bytes, 1, file) != 1))
+	  goto fail;
+      }
+    if (fclose(file) != 0)
+      {
+	file = nullptr;
+	goto fail;
+      }
+    
+    if (rename(temporary.c_str(), this->path.c_str()) != 0)
+      {
+	saved_errno = errno;
+	remove(temporary.c_str());
+	throw create_error(saved_errno);
+      }
+    return;
+  
+  fail:
+    saved_errno = errno;
+    if (file != nullptr)
+      fclose(file);
+    remove(temporary.c_str());
+    throw create_error(saved_errno);
+  }
+  
+  
+#define __LIBGAMMA_CALIBRATION(T)								\
+  template void CalibrationCache::store<T>(const CalibrationKey& key, const GammaRamps<T>* ramps);	\
+  template bool CalibrationCache::lookup<T>(const CalibrationKey& key, GammaRamps<T>* ramps);	\
+  template bool CalibrationCache::apply<T>(const CalibrationKey& key, CRTC* crtc)
+  
+  __LIBGAMMA_CALIBRATION(uint8_t);
+  __LIBGAMMA_CALIBRATION(uint16_t);
+  __LIBGAMMA_CALIBRATION(uint32_t);
+  __LIBGAMMA_CALIBRATION(uint64_t);
+  __LIBGAMMA_CALIBRATION(float);
+  __LIBGAMMA_CALIBRATION(double);
+  
+#undef __LIBGAMMA_CALIBRATION
+
+}
+
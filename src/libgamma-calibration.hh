@@ -0,0 +1,313 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_CALIBRATION_HH
+#define LIBGAMMA_CALIBRATION_HH
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * Identifies the calibration of a monitor on a CRTC:
+   * the hash of its EDID, and the gamma ramp sizes and
+   * gamma depth of the CRTC.
+   */
+  class CalibrationKey
+  {
+  public:
+    /**
+     * Constructor, creates a key that matches nothing stored.
+     */
+    CalibrationKey();
+    
+    /**
+     * Constructor.
+     * 
+     * @param  edid         The monitor's EDID in raw representation.
+     * @param  edid_length  The length of `edid`.
+     * @param  red          The size of the red gamma ramp.
+     * @param  green        The size of the green gamma ramp.
+     * @param  blue         The size of the blue gamma ramp.
+     * @param  gamma_depth  The gamma depth of the CRTC.
+     */
+    CalibrationKey(const unsigned char* edid, size_t edid_length,
+		   size_t red, size_t green, size_t blue, signed gamma_depth);
+    
+    /**
+     * Constructor.
+     * 
+     * @param  info  Information about the CRTC, `edid`, `edid_length`,
+     *               `red_gamma_size`, `green_gamma_size`, `blue_gamma_size`
+     *               and `gamma_depth` must have been read.
+     */
+    CalibrationKey(const CRTCInformation& info);
+    
+    /**
+     * Compare with another key.
+     * 
+     * @param   other  The other key.
+     * @return         Whether the keys are equal.
+     */
+    bool operator ==(const CalibrationKey& other) const __attribute__((pure));
+    
+    
+    
+    /**
+     * The hash of the EDID.
+     */
+    uint64_t edid_hash;
+    
+    /**
+     * The size of the red gamma ramp.
+     */
+    size_t red_size;
+    
+    /**
+     * The size of the green gamma ramp.
+     */
+    size_t green_size;
+    
+    /**
+     * The size of the blue gamma ramp.
+     */
+    size_t blue_size;
+    
+    /**
+     * The gamma depth of the CRTC.
+     */
+    signed depth;
+    
+  };
+  
+  
+  /**
+   * Hash function for `CalibrationKey`.
+   */
+  class CalibrationKeyHash
+  {
+  public:
+    /**
+     * Hash a key.
+     * 
+     * @param   key  The key.
+     * @return       The hash of the key.
+     */
+    size_t operator ()(const CalibrationKey& key) const __attribute__((pure));
+    
+  };
+  
+  
+  /**
+   * A cached calibration.
+   */
+  class CalibrationEntry;
+  
+  
+  /**
+   * A cache of calibrated gamma ramps, keyed by monitor and CRTC,
+   * so that a known monitor can get its calibration applied with
+   * one lookup instead of having its ramps recomputed.
+   * 
+   * The cache holds at most `capacity` calibrations in memory and
+   * evicts the least recently used when it is full. It can be saved
+   * to and loaded from a file, in the native byte order. The cache
+   * is thread-safe.
+   */
+  class CalibrationCache
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  max_entries  The maximum number of cached calibrations.
+     * @param  file         The file used by `load` and `save`, empty for none.
+     */
+    CalibrationCache(size_t max_entries = 32, const std::string& file = "");
+    
+    /**
+     * Destructor.
+     */
+    ~CalibrationCache();
+    
+    /**
+     * Store a calibration, replacing any previous calibration
+     * with the same key. The gamma ramps are copied.
+     * 
+     * @param  key    The key.
+     * @param  ramps  The calibrated gamma ramps, their sizes should
+     *                match those in the key.
+     */
+    template <typename T>
+    void store(const CalibrationKey& key, const GammaRamps<T>* ramps);
+    
+    /**
+     * Look up a calibration and copy it into gamma ramps.
+     * 
+     * @param   key    The key.
+     * @param   ramps  Gamma ramps, with the sizes in the key, to fill.
+     * @return         Whether the calibration was cached with
+     *                 the same element type as `ramps`.
+     */
+    template <typename T>
+    bool lookup(const CalibrationKey& key, GammaRamps<T>* ramps);
+    
+    /**
+     * Look up a calibration and apply it to a CRTC,
+     * directly from the cache without copying it.
+     * 
+     * @param   key   The key.
+     * @param   crtc  The CRTC.
+     * @return        Whether the calibration was cached with the
+     *                element type `T`, and thus was applied.
+     */
+    template <typename T>
+    bool apply(const CalibrationKey& key, CRTC* crtc);
+    
+    /**
+     * Remove a calibration.
+     * 
+     * @param   key  The key.
+     * @return       Whether the calibration was cached.
+     */
+    bool erase(const CalibrationKey& key);
+    
+    /**
+     * Remove all calibrations.
+     */
+    void clear();
+    
+    /**
+     * Get the number of cached calibrations.
+     * 
+     * @return  The number of cached calibrations.
+     */
+    size_t size() const;
+    
+    /**
+     * Load calibrations from `path`, in addition to those already
+     * cached. `EINVAL` is thrown if the file is malformed or
+     * truncated.
+     * 
+     * @return  Whether the file existed.
+     */
+    bool load();
+    
+    /**
+     * Save the calibrations to `path`. The file is
+     * replaced atomically by writing a uniquely named
+     * temporary file next to it and renaming it, so
+     * concurrent saves do not interfere, the last
+     * rename wins. The file is only readable and
+     * writable by its owner.
+     */
+    void save() const;
+    
+    
+    
+    /**
+     * The maximum number of cached calibrations.
+     */
+    size_t capacity;
+    
+    /**
+     * The file used by `load` and `save`, empty for none.
+     */
+    std::string path;
+    
+    /**
+     * The number of lookups that found a calibration.
+     */
+    std::atomic<uint64_t> hits;
+    
+    /**
+     * The number of lookups that did not find a calibration.
+     */
+    std::atomic<uint64_t> misses;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    CalibrationCache(const CalibrationCache&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    CalibrationCache& operator =(const CalibrationCache&) = delete;
+    
+    /**
+     * Find a calibration and mark it as the most recently used.
+     * 
+     * @param   key    The key.
+     * @param   depth  The element depth the calibration must have been stored with.
+     * @return         The calibration, `nullptr` if not found.
+     */
+    std::shared_ptr<CalibrationEntry> find(const CalibrationKey& key, signed depth);
+    
+    /**
+     * Insert a calibration as the most recently used,
+     * and evict calibrations if the cache is over capacity.
+     * 
+     * @param  entry  The calibration.
+     */
+    void insert(std::shared_ptr<CalibrationEntry> entry);
+    
+    /**
+     * The calibrations, the most recently used first.
+     */
+    std::list<std::shared_ptr<CalibrationEntry>> recency;
+    
+    /**
+     * The calibrations by key.
+     */
+    std::unordered_map<CalibrationKey, std::list<std::shared_ptr<CalibrationEntry>>::iterator,
+		       CalibrationKeyHash> entries;
+    
+    /**
+     * Guards `recency` and `entries`.
+     */
+    mutable std::mutex mutex;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,231 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-context.hh"
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+
+
+namespace libgamma
+{
+  /**
+   * Held whilst a site or partition is opened through a context,
+   * so that `libgamma_group_gid` and `libgamma_group_name` are
+   * not overwritten before the context has read them.
+   */
+  static std::mutex group_mutex;
+  
+  
+  /**
+   * Get the time elapsed since a point in time.
+   * 
+   * @param   start  The point in time.
+   * @return         The elapsed time, in nanoseconds.
+   */
+  static uint64_t elapsed_ns(std::chrono::steady_clock::time_point start)
+  {
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    return (uint64_t)(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+  
+  
+  /**
+   * Constructor.
+   * 
+   * @param  arena_cache_limit    The maximum number of released blocks
+   *                              to keep for each block size in `arena`.
+   * @param  calibration_entries  The maximum number of calibrations in `calibration`.
+   * @param  calibration_file     The file `calibration` is loaded from and
+   *                              saved to, empty for none.
+   */
+  Context::Context(size_t arena_cache_limit, size_t calibration_entries,
+		   const std::string& calibration_file) :
+    group_gid(0),
+    group_name(),
+    arena(arena_cache_limit),
+    calibration(calibration_entries, calibration_file),
+    stats()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  Context::~Context()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Open a site.
+   * 
+   * @param   method  The adjustment method of the site.
+   * @param   site    The site identifier, will be moved into
+   *                  the structure, must be `delete`:able.
+   * @return          The site.
+   */
+  Site* Context::open_site(int method, std::string* site)
+  {
+    Result<Site*> r = this->try_open_site(method, site);
+    if (!r.ok())
+      __LIBGAMMA_THROW(r.error);
+    return r.value;
+  }
+  
+  /**
+   * Open a site without throwing.
+   * 
+   * @param   method  The adjustment method of the site.
+   * @param   site    The site identifier, will be moved into the
+   *                  structure, must be `delete`:able, it is
+   *                  deleted if the site cannot be opened.
+   * @return          The site, or the error code.
+   */
+  Result<Site*> Context::try_open_site(int method, std::string* site) noexcept
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(group_mutex);
+    Result<Site*> r = Site::open(method, site);
+    this->report_group(r.error);
+    this->stats.record(STATS_SITE_INITIALISE, elapsed_ns(start), !r.ok());
+    return r;
+  }
+  
+  /**
+   * Open a partition.
+   * 
+   * @param   site       The site of the partition.
+   * @param   partition  The index of the partition.
+   * @return             The partition.
+   */
+  Partition* Context::open_partition(Site* site, size_t partition)
+  {
+    Result<Partition*> r = this->try_open_partition(site, partition);
+    if (!r.ok())
+      __LIBGAMMA_THROW(r.error);
+    return r.value;
+  }
+  
+  /**
+   * Open a partition without throwing.
+   * 
+   * @param   site       The site of the partition.
+   * @param   partition  The index of the partition.
+   * @return             The partition, or the error code.
+   */
+  Result<Partition*> Context::try_open_partition(Site* site, size_t partition) noexcept
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(group_mutex);
+    Result<Partition*> r = Partition::open(site, partition);
+    this->report_group(r.error);
+    this->stats.record(STATS_PARTITION_INITIALISE, elapsed_ns(start), !r.ok());
+    return r;
+  }
+  
+  /**
+   * Open a CRTC.
+   * 
+   * @param   partition  The partition of the CRTC.
+   * @param   crtc       The index of the CRTC.
+   * @return             The CRTC.
+   */
+  CRTC* Context::open_crtc(Partition* partition, size_t crtc)
+  {
+    Result<CRTC*> r = this->try_open_crtc(partition, crtc);
+    if (!r.ok())
+      __LIBGAMMA_THROW(r.error);
+    return r.value;
+  }
+  
+  /**
+   * Open a CRTC without throwing.
+   * 
+   * @param   partition  The partition of the CRTC.
+   * @param   crtc       The index of the CRTC.
+   * @return             The CRTC, or the error code.
+   */
+  Result<CRTC*> Context::try_open_crtc(Partition* partition, size_t crtc) noexcept
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Result<CRTC*> r = CRTC::open(partition, crtc);
+    this->stats.record(STATS_CRTC_INITIALISE, elapsed_ns(start), !r.ok());
+    return r;
+  }
+  
+  /**
+   * Prints an error to stderr in the same fashion as `perror`,
+   * but with the required group reported into the context.
+   * 
+   * @param  name        The text to add at the beginning.
+   * @param  error_code  The error code, may be an `errno` value.
+   */
+  void Context::perror(const std::string& name, int error_code) const
+  {
+    if (error_code != LIBGAMMA_DEVICE_REQUIRE_GROUP)
+      libgamma::perror(name, error_code);
+    else if (this->group_name.empty())
+      std::cerr << name << ": LIBGAMMA_DEVICE_REQUIRE_GROUP: "
+		<< (unsigned long)(this->group_gid) << std::endl;
+    else
+      std::cerr << name << ": LIBGAMMA_DEVICE_REQUIRE_GROUP: " << this->group_name
+		<< " (" << (unsigned long)(this->group_gid) << ")" << std::endl;
+  }
+  
+  /**
+   * Take a snapshot of the statistics for the
+   * sites, partitions and CRTC:s opened through
+   * the context.
+   * 
+   * @param  output  Output parameter for the snapshot.
+   */
+  void Context::statistics(Stats* output) const
+  {
+    this->stats.snapshot(output);
+  }
+  
+  /**
+   * Store the group reported by `libgamma` if an
+   * open failed with `LIBGAMMA_DEVICE_REQUIRE_GROUP`.
+   * 
+   * @param  error_code  The error code of the open.
+   */
+  void Context::report_group(int error_code) noexcept
+  {
+    if (error_code != LIBGAMMA_DEVICE_REQUIRE_GROUP)
+      return;
+    this->group_gid = libgamma_group_gid;
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+    try
+#endif
+      {
+	this->group_name.assign(libgamma_group_name == nullptr ? "" : libgamma_group_name);
+      }
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+    catch (...)
+      {
+	/* Out of memory, the name is left unknown. */
+	this->group_name.clear();
+      }
+#endif
+  }
+  
+}
+
@@ -0,0 +1,234 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_CONTEXT_HH
+#define LIBGAMMA_CONTEXT_HH
+
+
+#include <cstddef>
+#include <string>
+
+#include "libgamma-native.hh"
+#include "libgamma-error.hh"
+#include "libgamma-method.hh"
+#include "libgamma-facade.hh"
+#include "libgamma-arena.hh"
+#include "libgamma-stats.hh"
+#include "libgamma-calibration.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * State that is otherwise shared by the whole process.
+   * 
+   * Sites, partitions and CRTC:s opened through a context report
+   * `LIBGAMMA_DEVICE_REQUIRE_GROUP` into the context, rather than
+   * only into `group_gid` and `group_name`, and the context has its
+   * own ramp arena, calibration cache and statistics counters. This
+   * lets independent subsystems run on their own threads without
+   * sharing mutable state. The group information is not guarded,
+   * so it should only be used by the thread that owns the context;
+   * the arena, the calibration cache and the counters are thread-safe.
+   * 
+   * `libgamma` itself reports the required group in two process-wide
+   * variables, so opening sites and partitions through contexts is
+   * serialised for as long as it takes to read them.
+   */
+  class Context
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  arena_cache_limit    The maximum number of released blocks
+     *                              to keep for each block size in `arena`.
+     * @param  calibration_entries  The maximum number of calibrations in `calibration`.
+     * @param  calibration_file     The file `calibration` is loaded from and
+     *                              saved to, empty for none.
+     */
+    Context(size_t arena_cache_limit = 16, size_t calibration_entries = 32,
+	    const std::string& calibration_file = "");
+    
+    /**
+     * Destructor.
+     * 
+     * All gamma ramps allocated from `arena`
+     * must have been released before the
+     * context is destroyed.
+     */
+    ~Context();
+    
+    /**
+     * Open a site.
+     * 
+     * @param   method  The adjustment method of the site.
+     * @param   site    The site identifier, will be moved into
+     *                  the structure, must be `delete`:able.
+     * @return          The site.
+     */
+    Site* open_site(int method, std::string* site = nullptr);
+    
+    /**
+     * Open a site without throwing.
+     * 
+     * @param   method  The adjustment method of the site.
+     * @param   site    The site identifier, will be moved into the
+     *                  structure, must be `delete`:able, it is
+     *                  deleted if the site cannot be opened.
+     * @return          The site, or the error code.
+     */
+    Result<Site*> try_open_site(int method, std::string* site = nullptr) noexcept;
+    
+    /**
+     * Open a partition.
+     * 
+     * @param   site       The site of the partition.
+     * @param   partition  The index of the partition.
+     * @return             The partition.
+     */
+    Partition* open_partition(Site* site, size_t partition);
+    
+    /**
+     * Open a partition without throwing.
+     * 
+     * @param   site       The site of the partition.
+     * @param   partition  The index of the partition.
+     * @return             The partition, or the error code.
+     */
+    Result<Partition*> try_open_partition(Site* site, size_t partition) noexcept;
+    
+    /**
+     * Open a CRTC.
+     * 
+     * @param   partition  The partition of the CRTC.
+     * @param   crtc       The index of the CRTC.
+     * @return             The CRTC.
+     */
+    CRTC* open_crtc(Partition* partition, size_t crtc);
+    
+    /**
+     * Open a CRTC without throwing.
+     * 
+     * @param   partition  The partition of the CRTC.
+     * @param   crtc       The index of the CRTC.
+     * @return             The CRTC, or the error code.
+     */
+    Result<CRTC*> try_open_crtc(Partition* partition, size_t crtc) noexcept;
+    
+    /**
+     * Create a gamma ramp from the context's arena,
+     * see `gamma_ramps_allocate`.
+     * 
+     * @param   red    The size of the gamma ramp for the red channel.
+     * @param   green  The size of the gamma ramp for the green channel.
+     * @param   blue   The size of the gamma ramp for the blue channel.
+     * @return         The gamma ramp.
+     */
+    template <typename T>
+    GammaRamps<T>* allocate_ramps(size_t red, size_t green, size_t blue)
+    {
+      return gamma_ramps_allocate<T>(red, green, blue, &(this->arena));
+    }
+    
+    /**
+     * Prints an error to stderr in the same fashion as `perror`,
+     * but with the required group reported into the context.
+     * 
+     * @param  name        The text to add at the beginning.
+     * @param  error_code  The error code, may be an `errno` value.
+     */
+    void perror(const std::string& name, int error_code) const;
+    
+    /**
+     * Take a snapshot of the statistics for the
+     * sites, partitions and CRTC:s opened through
+     * the context.
+     * 
+     * @param  output  Output parameter for the snapshot.
+     */
+    void statistics(Stats* output) const;
+    
+    
+    
+    /**
+     * Group that the user needs to be a member of if
+     * `LIBGAMMA_DEVICE_REQUIRE_GROUP` was returned
+     * when a site or partition was opened through the
+     * context, zero if it never was.
+     */
+    libgamma_gid_t group_gid;
+    
+    /**
+     * The name of the group `group_gid`, empty if
+     * it cannot be determined.
+     */
+    std::string group_name;
+    
+    /**
+     * The arena gamma ramps are allocated from by `allocate_ramps`.
+     */
+    RampArena arena;
+    
+    /**
+     * Calibrations, by monitor and gamma ramp format.
+     */
+    CalibrationCache calibration;
+    
+    /**
+     * The statistics counters for the sites, partitions
+     * and CRTC:s opened through the context, only their
+     * initialisation is recorded.
+     */
+    StatsCounters stats;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    Context(const Context&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    Context& operator =(const Context&) = delete;
+    
+    /**
+     * Store the group reported by `libgamma` if an
+     * open failed with `LIBGAMMA_DEVICE_REQUIRE_GROUP`.
+     * 
+     * @param  error_code  The error code of the open.
+     */
+    void report_group(int error_code) noexcept;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
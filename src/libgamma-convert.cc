@@ -0,0 +1,620 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-convert.hh"
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__GCC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+# define LIBGAMMA_HAVE_SSE2
+# include <immintrin.h>
+#endif
+#if defined(__GCC__) && defined(__ARM_NEON) && defined(__aarch64__)
+# define LIBGAMMA_HAVE_NEON
+# include <arm_neon.h>
+#endif
+
+
+namespace libgamma
+{
+  /**
+   * The type calculations are done in when converting between
+   * a floating point type and another type. Single precision
+   * is sufficient when converting an integer of at most 16 bits
+   * to single precision, otherwise double precision is needed
+   * for correct rounding.
+   */
+  template <typename T, typename U>
+  struct ConversionPrecision
+  {
+    typedef typename std::conditional<std::is_same<U, float>::value && (sizeof(T) <= 2),
+				      float, double>::type type;
+  };
+  
+  
+  /**
+   * Conversion of a single stop, specialised on whether
+   * the input and the output types are integer types.
+   */
+  template <typename T, typename U,
+	    bool T_INT = std::numeric_limits<T>::is_integer,
+	    bool U_INT = std::numeric_limits<U>::is_integer,
+	    bool WIDEN = (sizeof(T) < sizeof(U))>
+  struct StopConversion;
+  
+  /**
+   * Integer to wider integer: multiplication by the repunit
+   * in base 2 to the power of the input's bit-depth, which
+   * is exact and maps the maximum onto the maximum.
+   */
+  template <typename T, typename U>
+  struct StopConversion<T, U, true, true, true>
+  {
+    static U convert(T value)
+    {
+      const U factor = std::numeric_limits<U>::max() / std::numeric_limits<T>::max();
+      return (U)((U)(value) * factor);
+    }
+  };
+  
+  /**
+   * Integer to narrower, or equally wide, integer: division
+   * by the repunit, rounded to nearest. The divisor is odd
+   * so there are no ties.
+   */
+  template <typename T, typename U>
+  struct StopConversion<T, U, true, true, false>
+  {
+    static U convert(T value)
+    {
+      const T divisor = (T)(std::numeric_limits<T>::max() / std::numeric_limits<U>::max());
+      T quotient = (T)(value / divisor);
+      T remainder = (T)(value - quotient * divisor);
+      return (U)(quotient + (remainder > divisor / 2 ? 1 : 0));
+    }
+  };
+  
+  /**
+   * Integer to floating point.
+   */
+  template <typename T, typename U, bool WIDEN>
+  struct StopConversion<T, U, true, false, WIDEN>
+  {
+    static U convert(T value)
+    {
+      typedef typename ConversionPrecision<T, U>::type W;
+      return (U)((W)(value) / (W)(std::numeric_limits<T>::max()));
+    }
+  };
+  
+  /**
+   * Floating point to integer, clamped and rounded to nearest.
+   */
+  template <typename T, typename U, bool WIDEN>
+  struct StopConversion<T, U, false, true, WIDEN>
+  {
+    static U convert(T value)
+    {
+      typedef typename ConversionPrecision<T, U>::type W;
+      W v = (W)(value);
+      if (!(v > 0))
+	return 0;
+      if (v >= 1)
+	return std::numeric_limits<U>::max();
+      return (U)(v * (W)(std::numeric_limits<U>::max()) + (W)(0.5));
+    }
+  };
+  
+  /**
+   * Floating point to floating point.
+   */
+  template <typename T, typename U, bool WIDEN>
+  struct StopConversion<T, U, false, false, WIDEN>
+  {
+    static U convert(T value)
+    {
+      return (U)(value);
+    }
+  };
+  
+  
+  /**
+   * Convert stops without vector instructions.
+   * 
+   * @param  from  The stops to convert.
+   * @param  to    Output buffer for the converted stops.
+   * @param  n     The number of stops to convert.
+   */
+  template <typename T, typename U>
+  static void convert_stops_scalar(const T* from, U* to, size_t n)
+  {
+    size_t i;
+    for (i = 0; i < n; i++)
+      to[i] = StopConversion<T, U>::convert(from[i]);
+  }
+  
+  
+  /**
+   * Convert a prefix of the stops with vector instructions,
+   * used for conversions that have no vectorised kernel.
+   * 
+   * @return  The number of converted stops, always zero.
+   */
+  template <typename T, typename U>
+  static size_t convert_stops_vector(const T*, U*, size_t)
+  {
+    return 0;
+  }
+  
+  
+#ifdef LIBGAMMA_HAVE_SSE2
+  
+  /**
+   * Check whether the processor supports AVX2.
+   * 
+   * @return  Whether AVX2 is supported.
+   */
+  static bool have_avx2()
+  {
+    static const bool rc = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+    return rc;
+  }
+  
+  /**
+   * Pack two vectors of 32-bit integers in [0, 0xFFFF] to
+   * unsigned 16-bit integers. SSE2 only has signed saturated
+   * packing so the values are biased into the signed range.
+   */
+  static inline __m128i sse2_pack_u16(__m128i low, __m128i high)
+  {
+    const __m128i bias = _mm_set1_epi32(0x8000);
+    const __m128i flip = _mm_set1_epi16((short)(-0x8000));
+    low  = _mm_sub_epi32(low,  bias);
+    high = _mm_sub_epi32(high, bias);
+    return _mm_xor_si128(_mm_packs_epi32(low, high), flip);
+  }
+  
+  /**
+   * Clamp, scale and round two doubles into 32-bit integers
+   * in the lower half of the result.
+   */
+  static inline __m128i sse2_pd_to_u16_epi32(__m128d v)
+  {
+    v = _mm_min_pd(_mm_max_pd(v, _mm_setzero_pd()), _mm_set1_pd(1.0));
+    v = _mm_add_pd(_mm_mul_pd(v, _mm_set1_pd(65535.0)), _mm_set1_pd(0.5));
+    return _mm_cvttpd_epi32(v);
+  }
+  
+  
+  /**
+   * Clamp, scale and round four doubles into 32-bit integers.
+   */
+  __attribute__((target("avx2")))
+  static inline __m128i avx2_pd_to_u16_epi32(__m256d v)
+  {
+    v = _mm256_min_pd(_mm256_max_pd(v, _mm256_setzero_pd()), _mm256_set1_pd(1.0));
+    v = _mm256_add_pd(_mm256_mul_pd(v, _mm256_set1_pd(65535.0)), _mm256_set1_pd(0.5));
+    return _mm256_cvttpd_epi32(v);
+  }
+  
+  /**
+   * Convert a prefix of the stops with AVX2.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  __attribute__((target("avx2")))
+  static size_t avx2_convert(const double* from, uint16_t* to, size_t n)
+  {
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8)
+      _mm_storeu_si128((__m128i*)(to + i),
+		       _mm_packus_epi32(avx2_pd_to_u16_epi32(_mm256_loadu_pd(from + i)),
+					avx2_pd_to_u16_epi32(_mm256_loadu_pd(from + i + 4))));
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with AVX2.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  __attribute__((target("avx2")))
+  static size_t avx2_convert(const float* from, uint16_t* to, size_t n)
+  {
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8)
+      _mm_storeu_si128((__m128i*)(to + i),
+		       _mm_packus_epi32(avx2_pd_to_u16_epi32(_mm256_cvtps_pd(_mm_loadu_ps(from + i))),
+					avx2_pd_to_u16_epi32(_mm256_cvtps_pd(_mm_loadu_ps(from + i + 4)))));
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with AVX2.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  __attribute__((target("avx2")))
+  static size_t avx2_convert(const uint16_t* from, double* to, size_t n)
+  {
+    const __m256d scale = _mm256_set1_pd(65535.0);
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	__m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+	__m256i w = _mm256_cvtepu16_epi32(v);
+	_mm256_storeu_pd(to + i,     _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(w)), scale));
+	_mm256_storeu_pd(to + i + 4, _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(w, 1)), scale));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with AVX2.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  __attribute__((target("avx2")))
+  static size_t avx2_convert(const uint16_t* from, float* to, size_t n)
+  {
+    const __m256 scale = _mm256_set1_ps(65535.0f);
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	__m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+	_mm256_storeu_ps(to + i, _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v)), scale));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with AVX2.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  __attribute__((target("avx2")))
+  static size_t avx2_convert(const uint8_t* from, uint16_t* to, size_t n)
+  {
+    const __m256i factor = _mm256_set1_epi16(0x0101);
+    size_t i;
+    for (i = 0; i + 16 <= n; i += 16)
+      {
+	__m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+	_mm256_storeu_si256((__m256i*)(to + i),
+			    _mm256_mullo_epi16(_mm256_cvtepu8_epi16(v), factor));
+      }
+    return i;
+  }
+  
+  
+  /**
+   * Convert a prefix of the stops with SSE2, or with AVX2 if supported by the processor.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const double* from, uint16_t* to, size_t n)
+  {
+    size_t i;
+    if (have_avx2())
+      return avx2_convert(from, to, n);
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	__m128i a = _mm_unpacklo_epi64(sse2_pd_to_u16_epi32(_mm_loadu_pd(from + i)),
+				       sse2_pd_to_u16_epi32(_mm_loadu_pd(from + i + 2)));
+	__m128i b = _mm_unpacklo_epi64(sse2_pd_to_u16_epi32(_mm_loadu_pd(from + i + 4)),
+				       sse2_pd_to_u16_epi32(_mm_loadu_pd(from + i + 6)));
+	_mm_storeu_si128((__m128i*)(to + i), sse2_pack_u16(a, b));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with SSE2, or with AVX2 if supported by the processor.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const float* from, uint16_t* to, size_t n)
+  {
+    size_t i;
+    if (have_avx2())
+      return avx2_convert(from, to, n);
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	__m128 a = _mm_loadu_ps(from + i);
+	__m128 b = _mm_loadu_ps(from + i + 4);
+	__m128i low = _mm_unpacklo_epi64(sse2_pd_to_u16_epi32(_mm_cvtps_pd(a)),
+					 sse2_pd_to_u16_epi32(_mm_cvtps_pd(_mm_movehl_ps(a, a))));
+	__m128i high = _mm_unpacklo_epi64(sse2_pd_to_u16_epi32(_mm_cvtps_pd(b)),
+					  sse2_pd_to_u16_epi32(_mm_cvtps_pd(_mm_movehl_ps(b, b))));
+	_mm_storeu_si128((__m128i*)(to + i), sse2_pack_u16(low, high));
+      }
+    return i;
+  }
+
+  
+  /**
+   * Convert a prefix of the stops with SSE2, or with AVX2 if supported by the processor.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const uint16_t* from, double* to, size_t n)
+  {
+    const __m128d scale = _mm_set1_pd(65535.0);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i;
+    if (have_avx2())
+      return avx2_convert(from, to, n);
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	__m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+	__m128i low = _mm_unpacklo_epi16(v, zero);
+	__m128i high = _mm_unpackhi_epi16(v, zero);
+	_mm_storeu_pd(to + i,     _mm_div_pd(_mm_cvtepi32_pd(low), scale));
+	_mm_storeu_pd(to + i + 2, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(low, 8)), scale));
+	_mm_storeu_pd(to + i + 4, _mm_div_pd(_mm_cvtepi32_pd(high), scale));
+	_mm_storeu_pd(to + i + 6, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(high, 8)), scale));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with SSE2, or with AVX2 if supported by the processor.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const uint16_t* from, float* to, size_t n)
+  {
+    const __m128 scale = _mm_set1_ps(65535.0f);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i;
+    if (have_avx2())
+      return avx2_convert(from, to, n);
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	__m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+	_mm_storeu_ps(to + i,     _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+	_mm_storeu_ps(to + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with SSE2, or with AVX2 if supported by the processor.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const uint8_t* from, uint16_t* to, size_t n)
+  {
+    size_t i;
+    if (have_avx2())
+      return avx2_convert(from, to, n);
+    for (i = 0; i + 16 <= n; i += 16)
+      {
+	__m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+	_mm_storeu_si128((__m128i*)(to + i),     _mm_unpacklo_epi8(v, v));
+	_mm_storeu_si128((__m128i*)(to + i + 8), _mm_unpackhi_epi8(v, v));
+      }
+    return i;
+  }
+  
+#endif
+
+
+#ifdef LIBGAMMA_HAVE_NEON
+  
+  /**
+   * Convert a prefix of the stops with NEON.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const double* from, uint16_t* to, size_t n)
+  {
+    const float64x2_t zero = vdupq_n_f64(0.0), one = vdupq_n_f64(1.0);
+    const float64x2_t scale = vdupq_n_f64(65535.0), half = vdupq_n_f64(0.5);
+    uint32x2_t parts[4];
+    size_t i, j;
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	for (j = 0; j < 4; j++)
+	  {
+	    float64x2_t v = vld1q_f64(from + i + 2 * j);
+	    v = vminq_f64(vmaxq_f64(v, zero), one);
+	    v = vaddq_f64(vmulq_f64(v, scale), half);
+	    parts[j] = vmovn_u64(vcvtq_u64_f64(v));
+	  }
+	vst1q_u16(to + i, vcombine_u16(vmovn_u32(vcombine_u32(parts[0], parts[1])),
+				       vmovn_u32(vcombine_u32(parts[2], parts[3]))));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with NEON.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const float* from, uint16_t* to, size_t n)
+  {
+    const float64x2_t zero = vdupq_n_f64(0.0), one = vdupq_n_f64(1.0);
+    const float64x2_t scale = vdupq_n_f64(65535.0), half = vdupq_n_f64(0.5);
+    uint32x2_t parts[4];
+    size_t i, j;
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	for (j = 0; j < 2; j++)
+	  {
+	    float32x4_t v = vld1q_f32(from + i + 4 * j);
+	    float64x2_t low = vcvt_f64_f32(vget_low_f32(v));
+	    float64x2_t high = vcvt_high_f64_f32(v);
+	    low  = vaddq_f64(vmulq_f64(vminq_f64(vmaxq_f64(low,  zero), one), scale), half);
+	    high = vaddq_f64(vmulq_f64(vminq_f64(vmaxq_f64(high, zero), one), scale), half);
+	    parts[2 * j]     = vmovn_u64(vcvtq_u64_f64(low));
+	    parts[2 * j + 1] = vmovn_u64(vcvtq_u64_f64(high));
+	  }
+	vst1q_u16(to + i, vcombine_u16(vmovn_u32(vcombine_u32(parts[0], parts[1])),
+				       vmovn_u32(vcombine_u32(parts[2], parts[3]))));
+      }
+    return i;
+  }
+
+  
+  /**
+   * Convert a prefix of the stops with NEON.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const uint16_t* from, double* to, size_t n)
+  {
+    const float64x2_t scale = vdupq_n_f64(65535.0);
+    size_t i;
+    for (i = 0; i + 4 <= n; i += 4)
+      {
+	uint32x4_t v = vmovl_u16(vld1_u16(from + i));
+	vst1q_f64(to + i,     vdivq_f64(vcvtq_f64_u64(vmovl_u32(vget_low_u32(v))),  scale));
+	vst1q_f64(to + i + 2, vdivq_f64(vcvtq_f64_u64(vmovl_u32(vget_high_u32(v))), scale));
+      }
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with NEON.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const uint16_t* from, float* to, size_t n)
+  {
+    const float32x4_t scale = vdupq_n_f32(65535.0f);
+    size_t i;
+    for (i = 0; i + 4 <= n; i += 4)
+      vst1q_f32(to + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vld1_u16(from + i))), scale));
+    return i;
+  }
+  
+  /**
+   * Convert a prefix of the stops with NEON.
+   * 
+   * @param   from  The stops to convert.
+   * @param   to    Output buffer for the converted stops.
+   * @param   n     The number of stops to convert.
+   * @return        The number of converted stops.
+   */
+  static size_t convert_stops_vector(const uint8_t* from, uint16_t* to, size_t n)
+  {
+    size_t i;
+    for (i = 0; i + 16 <= n; i += 16)
+      {
+	uint8x16_t v = vld1q_u8(from + i);
+	vst1q_u16(to + i,     vreinterpretq_u16_u8(vzip1q_u8(v, v)));
+	vst1q_u16(to + i + 8, vreinterpretq_u16_u8(vzip2q_u8(v, v)));
+      }
+    return i;
+  }
+  
+#endif
+  
+  
+  /**
+   * Convert gamma ramp stops from one element type to another.
+   * 
+   * Integer stops are rescaled so that the full range of the
+   * input type maps onto the full range of the output type,
+   * rounding to the nearest value. Floating point stops are
+   * in the range [0, 1] and are clamped to that range, with
+   * NaN mapped to zero, when converted to an integer type.
+   * 
+   * @param  from  The stops to convert.
+   * @param  to    Output buffer for the converted stops,
+   *               must not overlap with `from`.
+   * @param  n     The number of stops to convert.
+   */
+  template <typename T, typename U>
+  void convert_stops(const T* from, U* to, size_t n)
+  {
+    size_t done;
+    if (std::is_same<T, U>::value)
+      {
+	memcpy(to, from, n * sizeof(T));
+	return;
+      }
+    done = convert_stops_vector(from, to, n);
+    convert_stops_scalar(from + done, to + done, n - done);
+  }
+  
+  
+#define __LIBGAMMA_CONVERT_FROM(T)							\
+  template void convert_stops<T, uint8_t>(const T* from, uint8_t* to, size_t n);	\
+  template void convert_stops<T, uint16_t>(const T* from, uint16_t* to, size_t n);	\
+  template void convert_stops<T, uint32_t>(const T* from, uint32_t* to, size_t n);	\
+  template void convert_stops<T, uint64_t>(const T* from, uint64_t* to, size_t n);	\
+  template void convert_stops<T, float>(const T* from, float* to, size_t n);		\
+  template void convert_stops<T, double>(const T* from, double* to, size_t n)
+  
+  __LIBGAMMA_CONVERT_FROM(uint8_t);
+  __LIBGAMMA_CONVERT_FROM(uint16_t);
+  __LIBGAMMA_CONVERT_FROM(uint32_t);
+  __LIBGAMMA_CONVERT_FROM(uint64_t);
+  __LIBGAMMA_CONVERT_FROM(float);
+  __LIBGAMMA_CONVERT_FROM(double);
+  
+#undef __LIBGAMMA_CONVERT_FROM
+
+}
+
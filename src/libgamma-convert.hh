@@ -0,0 +1,103 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_CONVERT_HH
+#define LIBGAMMA_CONVERT_HH
+
+
+#include <cstddef>
+#include <cerrno>
+
+#include "libgamma-method.hh"
+#include "libgamma-error.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * Convert gamma ramp stops from one element type to another.
+   * 
+   * Integer stops are rescaled so that the full range of the
+   * input type maps onto the full range of the output type,
+   * rounding to the nearest value. Floating point stops are
+   * in the range [0, 1] and are clamped to that range, with
+   * NaN mapped to zero, when converted to an integer type.
+   * 
+   * The element types supported are `uint8_t`, `uint16_t`,
+   * `uint32_t`, `uint64_t`, `float` and `double`. Conversions
+   * between `double` or `float` and `uint16_t`, and from
+   * `uint8_t` to `uint16_t`, use SSE2, AVX2 or NEON if
+   * available, selected at runtime.
+   * 
+   * @param  from  The stops to convert.
+   * @param  to    Output buffer for the converted stops,
+   *               must not overlap with `from`.
+   * @param  n     The number of stops to convert.
+   */
+  template <typename T, typename U>
+  void convert_stops(const T* from, U* to, size_t n);
+  
+  /**
+   * Convert a gamma ramp from one element type to another.
+   * 
+   * @param  from  The ramp to convert.
+   * @param  to    The ramp to store the converted stops in,
+   *               must be the same size as `from`.
+   */
+  template <typename T, typename U>
+  void convert_ramp(const Ramp<T>* from, Ramp<U>* to)
+  {
+    if (from->size != to->size)
+      throw create_error(EINVAL);
+    convert_stops(from->ramp, to->ramp, from->size);
+  }
+  
+  /**
+   * Convert gamma ramps from one element type to another,
+   * for example from `double` used for calculations to the
+   * 16-bit ramps used by the CRTC.
+   * 
+   * @param  from  The gamma ramps to convert.
+   * @param  to    The gamma ramps to store the converted stops in,
+   *               each channel must be the same size as in `from`.
+   */
+  template <typename T, typename U>
+  void convert_gamma_ramps(const GammaRamps<T>* from, GammaRamps<U>* to)
+  {
+    if ((from->red.size != to->red.size) || (from->green.size != to->green.size) ||
+	(from->blue.size != to->blue.size))
+      throw create_error(EINVAL);
+    convert_stops(from->red.ramp,   to->red.ramp,   from->red.size);
+    convert_stops(from->green.ramp, to->green.ramp, from->green.size);
+    convert_stops(from->blue.ramp,  to->blue.ramp,  from->blue.size);
+  }
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
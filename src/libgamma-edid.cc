@@ -0,0 +1,269 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-edid.hh"
+
+
+namespace libgamma
+{
+  /**
+   * The fixed pattern an EDID starts with.
+   */
+  static const unsigned char edid_header[8] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+  
+  
+  /**
+   * Constructor.
+   * 
+   * @param  edid_data    The EDID in raw representation.
+   * @param  edid_length  The length of `edid_data`.
+   */
+  EdidView::EdidView(const unsigned char* edid_data, size_t edid_length) :
+    data(edid_data), length(edid_data == nullptr ? 0 : edid_length)
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Constructor.
+   * 
+   * @param  info  CRTC information whose EDID shall be viewed, `edid`
+   *               and `edid_length` are used, but nothing is copied.
+   */
+  EdidView::EdidView(const CRTCInformation& info) :
+    data(info.edid), length(info.edid == nullptr ? 0 : info.edid_length)
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Check whether the EDID is at least as long as its base block, has
+   * the fixed header pattern and the base block's checksum is correct.
+   * 
+   * @return  Whether the EDID appears to be valid.
+   */
+  bool EdidView::valid() const
+  {
+    size_t i;
+    if (this->length < BLOCK_SIZE)
+      return false;
+    for (i = 0; i < sizeof(edid_header); i++)
+      if (this->data[i] != edid_header[i])
+	return false;
+    return this->checksum_ok(0);
+  }
+  
+  /**
+   * Check the checksum of a block.
+   * 
+   * @param   block  The index of the block, 0 for the base block.
+   * @return         Whether the block exists and its checksum is correct.
+   */
+  bool EdidView::checksum_ok(size_t block) const
+  {
+    const unsigned char* p;
+    unsigned sum = 0;
+    size_t i;
+    if (block >= this->length / BLOCK_SIZE)
+      return false;
+    p = this->data + block * BLOCK_SIZE;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      sum += p[i];
+    return (sum & 255) == 0;
+  }
+  
+  /**
+   * Check the checksums of the base block and all extension blocks.
+   * 
+   * @return  Whether all blocks exist and their checksums are correct.
+   */
+  bool EdidView::checksums_ok() const
+  {
+    size_t i, n = this->extension_count();
+    for (i = 0; i <= n; i++)
+      if (!this->checksum_ok(i))
+	return false;
+    return true;
+  }
+  
+  /**
+   * Get the manufacturer ID, the PNP ID of the manufacturer.
+   * 
+   * @param  output  Output buffer for the three-letter ID, it will be NUL-terminated,
+   *                 it will be the empty string if the EDID is too short.
+   */
+  void EdidView::manufacturer(char output[4]) const
+  {
+    unsigned id;
+    if (this->length < BLOCK_SIZE)
+      {
+	output[0] = '\0';
+	return;
+      }
+    /* Three 5-bit letters, big-endian, 1 for 'A'. */
+    id = ((unsigned)(this->data[8]) << 8) | this->data[9];
+    output[0] = (char)('A' - 1 + ((id >> 10) & 31));
+    output[1] = (char)('A' - 1 + ((id >>  5) & 31));
+    output[2] = (char)('A' - 1 + ((id >>  0) & 31));
+    output[3] = '\0';
+  }
+  
+  /**
+   * Get the manufacturer's product code.
+   * 
+   * @return  The product code.
+   */
+  uint16_t EdidView::product_code() const
+  {
+    if (this->length < BLOCK_SIZE)
+      return 0;
+    return (uint16_t)(this->data[10] | (this->data[11] << 8));
+  }
+  
+  /**
+   * Get the serial number.
+   * 
+   * @return  The serial number, zero if not used.
+   */
+  uint32_t EdidView::serial_number() const
+  {
+    if (this->length < BLOCK_SIZE)
+      return 0;
+    return ((uint32_t)(this->data[12]) <<  0) | ((uint32_t)(this->data[13]) <<  8) |
+	   ((uint32_t)(this->data[14]) << 16) | ((uint32_t)(this->data[15]) << 24);
+  }
+  
+  /**
+   * Get the week of manufacture.
+   * 
+   * @return  The week of manufacture, 1 to 54, 0 if unspecified,
+   *          255 if `manufacture_year` is the model year.
+   */
+  unsigned EdidView::manufacture_week() const
+  {
+    return this->length < BLOCK_SIZE ? 0 : this->data[16];
+  }
+  
+  /**
+   * Get the year of manufacture, or the model year.
+   * 
+   * @return  The year, zero if the EDID is too short.
+   */
+  unsigned EdidView::manufacture_year() const
+  {
+    return this->length < BLOCK_SIZE ? 0 : 1990 + (unsigned)(this->data[17]);
+  }
+  
+  /**
+   * Get the EDID version.
+   * 
+   * @return  The version.
+   */
+  unsigned EdidView::version() const
+  {
+    return this->length < BLOCK_SIZE ? 0 : this->data[18];
+  }
+  
+  /**
+   * Get the EDID revision.
+   * 
+   * @return  The revision.
+   */
+  unsigned EdidView::revision() const
+  {
+    return this->length < BLOCK_SIZE ? 0 : this->data[19];
+  }
+  
+  /**
+   * Get the display gamma stored in the EDID.
+   * 
+   * @return  The gamma, in [1, 3.54], zero if it is not stored
+   *          in the base block or if the EDID is too short.
+   */
+  double EdidView::gamma() const
+  {
+    /* 0xFF means that the gamma is stored in an extension block. */
+    if ((this->length < BLOCK_SIZE) || (this->data[23] == 0xFF))
+      return 0;
+    return (this->data[23] + 100) / 100.0;
+  }
+  
+  /**
+   * Get the chromaticity coordinates of the monitor.
+   * 
+   * @param   output  Output parameter for the coordinates.
+   * @return          Whether the EDID was long enough.
+   */
+  bool EdidView::chromaticity(EdidChromaticity* output) const
+  {
+    const unsigned char* p = this->data;
+    if (this->length < BLOCK_SIZE)
+      return false;
+    /* Each coordinate is a 10-bit fraction, the high 8 bits are stored
+     * in bytes 27 to 34 and the low 2 bits are packed into 25 and 26. */
+#define __LIBGAMMA_CHROMATICITY(HIGH, LOW, SHIFT)  \
+    ((double)((p[HIGH] << 2) | ((p[LOW] >> SHIFT) & 3)) / 1024)
+    output->red_x   = __LIBGAMMA_CHROMATICITY(27, 25, 6);
+    output->red_y   = __LIBGAMMA_CHROMATICITY(28, 25, 4);
+    output->green_x = __LIBGAMMA_CHROMATICITY(29, 25, 2);
+    output->green_y = __LIBGAMMA_CHROMATICITY(30, 25, 0);
+    output->blue_x  = __LIBGAMMA_CHROMATICITY(31, 26, 6);
+    output->blue_y  = __LIBGAMMA_CHROMATICITY(32, 26, 4);
+    output->white_x = __LIBGAMMA_CHROMATICITY(33, 26, 2);
+    output->white_y = __LIBGAMMA_CHROMATICITY(34, 26, 0);
+#undef __LIBGAMMA_CHROMATICITY
+    return true;
+  }
+  
+  /**
+   * Get the number of extension blocks the EDID declares.
+   * 
+   * @return  The number of extension blocks.
+   */
+  size_t EdidView::extension_count() const
+  {
+    return this->length < BLOCK_SIZE ? 0 : this->data[126];
+  }
+  
+  /**
+   * Get an extension block.
+   * 
+   * @param   index  The index of the extension block, 0 for the first.
+   * @return         The extension block, which is `BLOCK_SIZE` bytes long,
+   *                 `nullptr` if it is not declared or is missing.
+   */
+  const unsigned char* EdidView::extension(size_t index) const
+  {
+    if ((index >= this->extension_count()) || (index + 1 >= this->length / BLOCK_SIZE))
+      return nullptr;
+    return this->data + (index + 1) * BLOCK_SIZE;
+  }
+  
+  /**
+   * Get the tag of an extension block, such as 0x02 for CEA-861.
+   * 
+   * @param   index  The index of the extension block, 0 for the first.
+   * @return         The tag, -1 if the block is not declared or is missing.
+   */
+  int EdidView::extension_tag(size_t index) const
+  {
+    const unsigned char* block = this->extension(index);
+    return block == nullptr ? -1 : *block;
+  }
+  
+}
+
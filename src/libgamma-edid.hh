@@ -0,0 +1,254 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_EDID_HH
+#define LIBGAMMA_EDID_HH
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * The chromaticity coordinates of a monitor, as stored in its EDID.
+   */
+  class EdidChromaticity
+  {
+  public:
+    /**
+     * The x-coordinate of the red primary.
+     */
+    double red_x;
+    
+    /**
+     * The y-coordinate of the red primary.
+     */
+    double red_y;
+    
+    /**
+     * The x-coordinate of the green primary.
+     */
+    double green_x;
+    
+    /**
+     * The y-coordinate of the green primary.
+     */
+    double green_y;
+    
+    /**
+     * The x-coordinate of the blue primary.
+     */
+    double blue_x;
+    
+    /**
+     * The y-coordinate of the blue primary.
+     */
+    double blue_y;
+    
+    /**
+     * The x-coordinate of the white point.
+     */
+    double white_x;
+    
+    /**
+     * The y-coordinate of the white point.
+     */
+    double white_y;
+    
+  };
+  
+  
+  /**
+   * A read-only view of an EDID in raw representation.
+   * 
+   * The view does not copy or allocate anything, it only
+   * points to the bytes, which must outlive it, and each
+   * field is decoded from them when it is requested. All
+   * fields read as zero if the EDID is shorter than the
+   * 128 bytes of its base block.
+   */
+  class EdidView
+  {
+  public:
+    /**
+     * The size of each block in an EDID.
+     */
+    static const size_t BLOCK_SIZE = 128;
+    
+    /**
+     * Constructor.
+     * 
+     * @param  edid_data    The EDID in raw representation.
+     * @param  edid_length  The length of `edid_data`.
+     */
+    EdidView(const unsigned char* edid_data, size_t edid_length);
+    
+    /**
+     * Constructor.
+     * 
+     * @param  info  CRTC information whose EDID shall be viewed, `edid`
+     *               and `edid_length` are used, but nothing is copied.
+     */
+    EdidView(const CRTCInformation& info);
+    
+    /**
+     * Check whether the EDID is at least as long as its base block, has
+     * the fixed header pattern and the base block's checksum is correct.
+     * 
+     * @return  Whether the EDID appears to be valid.
+     */
+    bool valid() const __attribute__((pure));
+    
+    /**
+     * Check the checksum of a block.
+     * 
+     * @param   block  The index of the block, 0 for the base block.
+     * @return         Whether the block exists and its checksum is correct.
+     */
+    bool checksum_ok(size_t block) const __attribute__((pure));
+    
+    /**
+     * Check the checksums of the base block and all extension blocks.
+     * 
+     * @return  Whether all blocks exist and their checksums are correct.
+     */
+    bool checksums_ok() const __attribute__((pure));
+    
+    /**
+     * Get the manufacturer ID, the PNP ID of the manufacturer.
+     * 
+     * @param  output  Output buffer for the three-letter ID, it will be NUL-terminated,
+     *                 it will be the empty string if the EDID is too short.
+     */
+    void manufacturer(char output[4]) const;
+    
+    /**
+     * Get the manufacturer's product code.
+     * 
+     * @return  The product code.
+     */
+    uint16_t product_code() const __attribute__((pure));
+    
+    /**
+     * Get the serial number.
+     * 
+     * @return  The serial number, zero if not used.
+     */
+    uint32_t serial_number() const __attribute__((pure));
+    
+    /**
+     * Get the week of manufacture.
+     * 
+     * @return  The week of manufacture, 1 to 54, 0 if unspecified,
+     *          255 if `manufacture_year` is the model year.
+     */
+    unsigned manufacture_week() const __attribute__((pure));
+    
+    /**
+     * Get the year of manufacture, or the model year.
+     * 
+     * @return  The year, zero if the EDID is too short.
+     */
+    unsigned manufacture_year() const __attribute__((pure));
+    
+    /**
+     * Get the EDID version.
+     * 
+     * @return  The version.
+     */
+    unsigned version() const __attribute__((pure));
+    
+    /**
+     * Get the EDID revision.
+     * 
+     * @return  The revision.
+     */
+    unsigned revision() const __attribute__((pure));
+    
+    /**
+     * Get the display gamma stored in the EDID.
+     * 
+     * @return  The gamma, in [1, 3.54], zero if it is not stored
+     *          in the base block or if the EDID is too short.
+     */
+    double gamma() const __attribute__((pure));
+    
+    /**
+     * Get the chromaticity coordinates of the monitor.
+     * 
+     * @param   output  Output parameter for the coordinates.
+     * @return          Whether the EDID was long enough.
+     */
+    bool chromaticity(EdidChromaticity* output) const;
+    
+    /**
+     * Get the number of extension blocks the EDID declares.
+     * 
+     * @return  The number of extension blocks.
+     */
+    size_t extension_count() const __attribute__((pure));
+    
+    /**
+     * Get an extension block.
+     * 
+     * @param   index  The index of the extension block, 0 for the first.
+     * @return         The extension block, which is `BLOCK_SIZE` bytes long,
+     *                 `nullptr` if it is not declared or is missing.
+     */
+    const unsigned char* extension(size_t index) const __attribute__((pure));
+    
+    /**
+     * Get the tag of an extension block, such as 0x02 for CEA-861.
+     * 
+     * @param   index  The index of the extension block, 0 for the first.
+     * @return         The tag, -1 if the block is not declared or is missing.
+     */
+    int extension_tag(size_t index) const __attribute__((pure));
+    
+    
+    
+    /**
+     * The EDID in raw representation.
+     */
+    const unsigned char* data;
+    
+    /**
+     * The length of `data`.
+     */
+    size_t length;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
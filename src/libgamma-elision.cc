@@ -0,0 +1,173 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-elision.hh"
+
+#include "libgamma-error.hh"
+#include "libgamma-hash.hh"
+
+#include <cstring>
+
+
+namespace libgamma
+{
+  /**
+   * Constructor.
+   * 
+   * @param  verify_contents  Whether to keep a copy of the last applied
+   *                          ramps and compare against it when the
+   *                          hashes match.
+   */
+  GammaElision::GammaElision(bool verify_contents) :
+    calls(0),
+    elided(0),
+    verify(verify_contents),
+    valid(false),
+    last_depth(0),
+    last_hash(0),
+    last_bytes{0, 0, 0},
+    last_contents(),
+    pending_depth(0),
+    pending_hash(0),
+    pending_ramps{nullptr, nullptr, nullptr},
+    pending_bytes{0, 0, 0}
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  GammaElision::~GammaElision()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Check whether gamma ramps are identical to the last applied
+   * gamma ramps. Unless they are, the ramps are remembered so
+   * that they can be committed with `applied`.
+   * 
+   * @param   gamma_depth  The depth of the ramps.
+   * @param   red_ramp     The red gamma ramp.
+   * @param   red_bytes    The size of the red gamma ramp, in bytes.
+   * @param   green_ramp   The green gamma ramp.
+   * @param   green_bytes  The size of the green gamma ramp, in bytes.
+   * @param   blue_ramp    The blue gamma ramp.
+   * @param   blue_bytes   The size of the blue gamma ramp, in bytes.
+   * @return               Whether the ramps are unchanged and
+   *                       setting them can be skipped.
+   */
+  bool GammaElision::unchanged(signed gamma_depth, const void* red_ramp, size_t red_bytes,
+			       const void* green_ramp, size_t green_bytes, const void* blue_ramp,
+			       size_t blue_bytes) noexcept
+  {
+    uint64_t hash;
+    size_t c;
+    
+    this->calls++;
+    
+    hash = hash_bytes(red_ramp, red_bytes, (uint64_t)(int64_t)gamma_depth);
+    hash = hash_bytes(green_ramp, green_bytes, hash);
+    hash = hash_bytes(blue_ramp, blue_bytes, hash);
+    
+    this->pending_depth = gamma_depth;
+    this->pending_hash = hash;
+    this->pending_ramps[0] = red_ramp;
+    this->pending_ramps[1] = green_ramp;
+    this->pending_ramps[2] = blue_ramp;
+    this->pending_bytes[0] = red_bytes;
+    this->pending_bytes[1] = green_bytes;
+    this->pending_bytes[2] = blue_bytes;
+    
+    if (!(this->valid) || (hash != this->last_hash) || (gamma_depth != this->last_depth))
+      return false;
+    for (c = 0; c < 3; c++)
+      if (this->pending_bytes[c] != this->last_bytes[c])
+	return false;
+    
+    if (this->verify && !(this->last_contents.empty()))
+      {
+	const unsigned char* contents = this->last_contents.data();
+	for (c = 0; c < 3; c++)
+	  {
+	    if (memcmp(contents, this->pending_ramps[c], this->pending_bytes[c]) != 0)
+	      return false;
+	    contents += this->pending_bytes[c];
+	  }
+      }
+    
+    this->elided++;
+    return true;
+  }
+  
+  /**
+   * Record that the ramps passed in the last call to
+   * `unchanged` have been applied successfully. If a copy
+   * of the ramps cannot be allocated, the memory is
+   * invalidated instead, so the next ramps are applied.
+   */
+  void GammaElision::applied() noexcept
+  {
+    size_t c;
+    this->valid = false;
+    if (this->verify)
+      {
+	unsigned char* contents;
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+	try
+#endif
+	  {
+	    this->last_contents.resize(this->pending_bytes[0] + this->pending_bytes[1] + this->pending_bytes[2]);
+	  }
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+	catch (...)
+	  {
+	    /* Out of memory, leave the memory invalidated. */
+	    this->last_contents.clear();
+	    return;
+	  }
+#endif
+	contents = this->last_contents.data();
+	for (c = 0; c < 3; c++)
+	  {
+	    memcpy(contents, this->pending_ramps[c], this->pending_bytes[c]);
+	    contents += this->pending_bytes[c];
+	  }
+      }
+    else
+      this->last_contents.clear();
+    this->last_depth = this->pending_depth;
+    this->last_hash = this->pending_hash;
+    for (c = 0; c < 3; c++)
+      this->last_bytes[c] = this->pending_bytes[c];
+    this->valid = true;
+  }
+  
+  /**
+   * Forget the last applied ramps, so that the next
+   * ramps are always applied. This must be done whenever
+   * the gamma ramps may have been changed by anything
+   * other than `CRTC::set_gamma`.
+   */
+  void GammaElision::invalidate() noexcept
+  {
+    this->valid = false;
+  }
+  
+}
+
@@ -0,0 +1,184 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_ELISION_HH
+#define LIBGAMMA_ELISION_HH
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * Memory of the last gamma ramps applied to a CRTC, used
+   * to skip setting the gamma ramps when they have not changed.
+   * 
+   * The ramps are compared by a 64-bit hash, and, if full
+   * verification is enabled, also against a copy of the
+   * ramps, so that a hash collision cannot skip a change.
+   */
+  class GammaElision
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  verify_contents  Whether to keep a copy of the last applied
+     *                          ramps and compare against it when the
+     *                          hashes match.
+     */
+    GammaElision(bool verify_contents = false);
+    
+    /**
+     * Destructor.
+     */
+    ~GammaElision();
+    
+    /**
+     * Check whether gamma ramps are identical to the last applied
+     * gamma ramps. Unless they are, the ramps are remembered so
+     * that they can be committed with `applied`.
+     * 
+     * @param   gamma_depth  The depth of the ramps.
+     * @param   red_ramp     The red gamma ramp.
+     * @param   red_bytes    The size of the red gamma ramp, in bytes.
+     * @param   green_ramp   The green gamma ramp.
+     * @param   green_bytes  The size of the green gamma ramp, in bytes.
+     * @param   blue_ramp    The blue gamma ramp.
+     * @param   blue_bytes   The size of the blue gamma ramp, in bytes.
+     * @return               Whether the ramps are unchanged and
+     *                       setting them can be skipped.
+     */
+    bool unchanged(signed gamma_depth, const void* red_ramp, size_t red_bytes,
+		   const void* green_ramp, size_t green_bytes, const void* blue_ramp, size_t blue_bytes) noexcept;
+    
+    /**
+     * Record that the ramps passed in the last call to
+     * `unchanged` have been applied successfully. If a copy
+     * of the ramps cannot be allocated, the memory is
+     * invalidated instead, so the next ramps are applied.
+     */
+    void applied() noexcept;
+    
+    /**
+     * Forget the last applied ramps, so that the next
+     * ramps are always applied. This must be done whenever
+     * the gamma ramps may have been changed by anything
+     * other than `CRTC::set_gamma`.
+     */
+    void invalidate() noexcept;
+    
+    
+    
+    /**
+     * The number of times the gamma ramps have been checked,
+     * that is, the number of `CRTC::set_gamma` calls.
+     */
+    uint64_t calls;
+    
+    /**
+     * The number of `CRTC::set_gamma` calls that were skipped
+     * because the gamma ramps had not changed.
+     */
+    uint64_t elided;
+    
+    /**
+     * Whether a copy of the last applied ramps is kept
+     * and compared against when the hashes match.
+     */
+    bool verify;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    GammaElision(const GammaElision&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    GammaElision& operator =(const GammaElision&) = delete;
+    
+    
+    
+    /**
+     * Whether `last_hash` describes the gamma ramps on the CRTC.
+     */
+    bool valid;
+    
+    /**
+     * The depth of the last applied ramps.
+     */
+    signed last_depth;
+    
+    /**
+     * The hash of the last applied ramps.
+     */
+    uint64_t last_hash;
+    
+    /**
+     * The sizes, in bytes, of the red, green and
+     * blue channels of the last applied ramps.
+     */
+    size_t last_bytes[3];
+    
+    /**
+     * The last applied ramps, with the channels after
+     * each other, if `verify` is set.
+     */
+    std::vector<unsigned char> last_contents;
+    
+    /**
+     * The depth of the ramps in the last call to `unchanged`.
+     */
+    signed pending_depth;
+    
+    /**
+     * The hash of the ramps in the last call to `unchanged`.
+     */
+    uint64_t pending_hash;
+    
+    /**
+     * The ramps in the last call to `unchanged`.
+     */
+    const void* pending_ramps[3];
+    
+    /**
+     * The sizes, in bytes, of the ramps in the last call to `unchanged`.
+     */
+    size_t pending_bytes[3];
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -18,6 +18,8 @@
 #include "libgamma-error.hh"
 
 #include <iostream>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 
 
@@ -54,7 +56,7 @@ namespace libgamma
    */
   std::string* name_of_error(int value)
   {
-    const char* cstr = libgamma_name_of_error(value);
+    const char* cstr = error_name(value);
     if (cstr == nullptr)
       return nullptr;
     return new std::string(cstr);
@@ -69,10 +71,274 @@ namespace libgamma
    */
   int value_of_error(const std::string* name)
   {
-    const char* cstr = nullptr;
-    if (name != nullptr)
-      cstr = name->c_str();
-    return libgamma_value_of_error(cstr);
+    int value;
+    if (name == nullptr)
+      return 0;
+    value = error_value(name->data(), name->size());
+    return value != 0 ? value : libgamma_value_of_error(name->c_str());
+  }
+  
+  
+  /**
+   * An entry in `error_names`.
+   */
+  class ErrorName
+  {
+  public:
+    /**
+     * The name of the error.
+     */
+    const char* name;
+    
+    /**
+     * The error code.
+     */
+    int value;
+    
+  };
+  
+  /**
+   * The names of the `libgamma` errors, sorted by name. Errors that
+   * the installed version of `libgamma` does not define are left out.
+   */
+  static const ErrorName error_names[] =
+    {
+#ifdef LIBGAMMA_ACQUIRING_MODE_RESOURCES_FAILED
+      { "LIBGAMMA_ACQUIRING_MODE_RESOURCES_FAILED", LIBGAMMA_ACQUIRING_MODE_RESOURCES_FAILED },
+#endif
+#ifdef LIBGAMMA_CONNECTOR_DISABLED
+      { "LIBGAMMA_CONNECTOR_DISABLED", LIBGAMMA_CONNECTOR_DISABLED },
+#endif
+#ifdef LIBGAMMA_CONNECTOR_TYPE_NOT_RECOGNISED
+      { "LIBGAMMA_CONNECTOR_TYPE_NOT_RECOGNISED", LIBGAMMA_CONNECTOR_TYPE_NOT_RECOGNISED },
+#endif
+#ifdef LIBGAMMA_CONNECTOR_UNKNOWN
+      { "LIBGAMMA_CONNECTOR_UNKNOWN", LIBGAMMA_CONNECTOR_UNKNOWN },
+#endif
+#ifdef LIBGAMMA_CRTC_INFO_NOT_SUPPORTED
+      { "LIBGAMMA_CRTC_INFO_NOT_SUPPORTED", LIBGAMMA_CRTC_INFO_NOT_SUPPORTED },
+#endif
+#ifdef LIBGAMMA_DEVICE_ACCESS_FAILED
+      { "LIBGAMMA_DEVICE_ACCESS_FAILED", LIBGAMMA_DEVICE_ACCESS_FAILED },
+#endif
+#ifdef LIBGAMMA_DEVICE_REQUIRE_GROUP
+      { "LIBGAMMA_DEVICE_REQUIRE_GROUP", LIBGAMMA_DEVICE_REQUIRE_GROUP },
+#endif
+#ifdef LIBGAMMA_DEVICE_RESTRICTED
+      { "LIBGAMMA_DEVICE_RESTRICTED", LIBGAMMA_DEVICE_RESTRICTED },
+#endif
+#ifdef LIBGAMMA_EDID_CHECKSUM_ERROR
+      { "LIBGAMMA_EDID_CHECKSUM_ERROR", LIBGAMMA_EDID_CHECKSUM_ERROR },
+#endif
+#ifdef LIBGAMMA_EDID_LENGTH_UNSUPPORTED
+      { "LIBGAMMA_EDID_LENGTH_UNSUPPORTED", LIBGAMMA_EDID_LENGTH_UNSUPPORTED },
+#endif
+#ifdef LIBGAMMA_EDID_NOT_FOUND
+      { "LIBGAMMA_EDID_NOT_FOUND", LIBGAMMA_EDID_NOT_FOUND },
+#endif
+#ifdef LIBGAMMA_EDID_REVISION_UNSUPPORTED
+      { "LIBGAMMA_EDID_REVISION_UNSUPPORTED", LIBGAMMA_EDID_REVISION_UNSUPPORTED },
+#endif
+#ifdef LIBGAMMA_EDID_WRONG_MAGIC_NUMBER
+      { "LIBGAMMA_EDID_WRONG_MAGIC_NUMBER", LIBGAMMA_EDID_WRONG_MAGIC_NUMBER },
+#endif
+#ifdef LIBGAMMA_ERRNO_SET
+      { "LIBGAMMA_ERRNO_SET", LIBGAMMA_ERRNO_SET },
+#endif
+#ifdef LIBGAMMA_GAMMA_NOT_SPECIFIED
+      { "LIBGAMMA_GAMMA_NOT_SPECIFIED", LIBGAMMA_GAMMA_NOT_SPECIFIED },
+#endif
+#ifdef LIBGAMMA_GAMMA_NOT_SPECIFIED_AND_EDID_CHECKSUM_ERROR
+      { "LIBGAMMA_GAMMA_NOT_SPECIFIED_AND_EDID_CHECKSUM_ERROR", LIBGAMMA_GAMMA_NOT_SPECIFIED_AND_EDID_CHECKSUM_ERROR },
+#endif
+#ifdef LIBGAMMA_GAMMA_RAMPS_SIZE_QUERY_FAILED
+      { "LIBGAMMA_GAMMA_RAMPS_SIZE_QUERY_FAILED", LIBGAMMA_GAMMA_RAMPS_SIZE_QUERY_FAILED },
+#endif
+#ifdef LIBGAMMA_GAMMA_RAMP_READ_FAILED
+      { "LIBGAMMA_GAMMA_RAMP_READ_FAILED", LIBGAMMA_GAMMA_RAMP_READ_FAILED },
+#endif
+#ifdef LIBGAMMA_GAMMA_RAMP_SIZE_CHANGED
+      { "LIBGAMMA_GAMMA_RAMP_SIZE_CHANGED", LIBGAMMA_GAMMA_RAMP_SIZE_CHANGED },
+#endif
+#ifdef LIBGAMMA_GAMMA_RAMP_WRITE_FAILED
+      { "LIBGAMMA_GAMMA_RAMP_WRITE_FAILED", LIBGAMMA_GAMMA_RAMP_WRITE_FAILED },
+#endif
+#ifdef LIBGAMMA_GRAPHICS_CARD_REMOVED
+      { "LIBGAMMA_GRAPHICS_CARD_REMOVED", LIBGAMMA_GRAPHICS_CARD_REMOVED },
+#endif
+#ifdef LIBGAMMA_IMPOSSIBLE_AMOUNT
+      { "LIBGAMMA_IMPOSSIBLE_AMOUNT", LIBGAMMA_IMPOSSIBLE_AMOUNT },
+#endif
+#ifdef LIBGAMMA_LIST_CRTCS_FAILED
+      { "LIBGAMMA_LIST_CRTCS_FAILED", LIBGAMMA_LIST_CRTCS_FAILED },
+#endif
+#ifdef LIBGAMMA_LIST_PARTITIONS_FAILED
+      { "LIBGAMMA_LIST_PARTITIONS_FAILED", LIBGAMMA_LIST_PARTITIONS_FAILED },
+#endif
+#ifdef LIBGAMMA_LIST_PROPERTIES_FAILED
+      { "LIBGAMMA_LIST_PROPERTIES_FAILED", LIBGAMMA_LIST_PROPERTIES_FAILED },
+#endif
+#ifdef LIBGAMMA_MIXED_GAMMA_RAMP_SIZE
+      { "LIBGAMMA_MIXED_GAMMA_RAMP_SIZE", LIBGAMMA_MIXED_GAMMA_RAMP_SIZE },
+#endif
+#ifdef LIBGAMMA_NEGATIVE_CRTC_COUNT
+      { "LIBGAMMA_NEGATIVE_CRTC_COUNT", LIBGAMMA_NEGATIVE_CRTC_COUNT },
+#endif
+#ifdef LIBGAMMA_NEGATIVE_PARTITION_COUNT
+      { "LIBGAMMA_NEGATIVE_PARTITION_COUNT", LIBGAMMA_NEGATIVE_PARTITION_COUNT },
+#endif
+#ifdef LIBGAMMA_NOT_CONNECTED
+      { "LIBGAMMA_NOT_CONNECTED", LIBGAMMA_NOT_CONNECTED },
+#endif
+#ifdef LIBGAMMA_NO_SUCH_ADJUSTMENT_METHOD
+      { "LIBGAMMA_NO_SUCH_ADJUSTMENT_METHOD", LIBGAMMA_NO_SUCH_ADJUSTMENT_METHOD },
+#endif
+#ifdef LIBGAMMA_NO_SUCH_CRTC
+      { "LIBGAMMA_NO_SUCH_CRTC", LIBGAMMA_NO_SUCH_CRTC },
+#endif
+#ifdef LIBGAMMA_NO_SUCH_PARTITION
+      { "LIBGAMMA_NO_SUCH_PARTITION", LIBGAMMA_NO_SUCH_PARTITION },
+#endif
+#ifdef LIBGAMMA_NO_SUCH_SITE
+      { "LIBGAMMA_NO_SUCH_SITE", LIBGAMMA_NO_SUCH_SITE },
+#endif
+#ifdef LIBGAMMA_NULL_PARTITION
+      { "LIBGAMMA_NULL_PARTITION", LIBGAMMA_NULL_PARTITION },
+#endif
+#ifdef LIBGAMMA_OPEN_CRTC_FAILED
+      { "LIBGAMMA_OPEN_CRTC_FAILED", LIBGAMMA_OPEN_CRTC_FAILED },
+#endif
+#ifdef LIBGAMMA_OPEN_PARTITION_FAILED
+      { "LIBGAMMA_OPEN_PARTITION_FAILED", LIBGAMMA_OPEN_PARTITION_FAILED },
+#endif
+#ifdef LIBGAMMA_OPEN_SITE_FAILED
+      { "LIBGAMMA_OPEN_SITE_FAILED", LIBGAMMA_OPEN_SITE_FAILED },
+#endif
+#ifdef LIBGAMMA_PROPERTY_VALUE_QUERY_FAILED
+      { "LIBGAMMA_PROPERTY_VALUE_QUERY_FAILED", LIBGAMMA_PROPERTY_VALUE_QUERY_FAILED },
+#endif
+#ifdef LIBGAMMA_PROTOCOL_VERSION_NOT_SUPPORTED
+      { "LIBGAMMA_PROTOCOL_VERSION_NOT_SUPPORTED", LIBGAMMA_PROTOCOL_VERSION_NOT_SUPPORTED },
+#endif
+#ifdef LIBGAMMA_PROTOCOL_VERSION_QUERY_FAILED
+      { "LIBGAMMA_PROTOCOL_VERSION_QUERY_FAILED", LIBGAMMA_PROTOCOL_VERSION_QUERY_FAILED },
+#endif
+#ifdef LIBGAMMA_REPLY_VALUE_EXTRACTION_FAILED
+      { "LIBGAMMA_REPLY_VALUE_EXTRACTION_FAILED", LIBGAMMA_REPLY_VALUE_EXTRACTION_FAILED },
+#endif
+#ifdef LIBGAMMA_SINGLETON_GAMMA_RAMP
+      { "LIBGAMMA_SINGLETON_GAMMA_RAMP", LIBGAMMA_SINGLETON_GAMMA_RAMP },
+#endif
+#ifdef LIBGAMMA_STATE_UNKNOWN
+      { "LIBGAMMA_STATE_UNKNOWN", LIBGAMMA_STATE_UNKNOWN },
+#endif
+#ifdef LIBGAMMA_SUBPIXEL_ORDER_NOT_RECOGNISED
+      { "LIBGAMMA_SUBPIXEL_ORDER_NOT_RECOGNISED", LIBGAMMA_SUBPIXEL_ORDER_NOT_RECOGNISED },
+#endif
+#ifdef LIBGAMMA_WRONG_GAMMA_RAMP_SIZE
+      { "LIBGAMMA_WRONG_GAMMA_RAMP_SIZE", LIBGAMMA_WRONG_GAMMA_RAMP_SIZE },
+#endif
+    };
+  
+  /**
+   * The number of elements in `error_names`.
+   */
+#define LIBGAMMA_ERROR_NAME_COUNT  (sizeof(error_names) / sizeof(*error_names))
+  
+  /**
+   * Get the name of the definition associated with a `libgamma` error
+   * code, without allocating memory. Errors that this library does
+   * not know about are looked up in `libgamma`.
+   * 
+   * @param   value  The error code.
+   * @return         The name of the definition associated with the error code,
+   *                 `nullptr` if the error code does not exist. The string is
+   *                 statically allocated and must not be freed.
+   */
+  const char* error_name(int value) noexcept
+  {
+    size_t i;
+    for (i = 0; i < LIBGAMMA_ERROR_NAME_COUNT; i++)
+      if (error_names[i].value == value)
+	return error_names[i].name;
+    return libgamma_name_of_error(value);
+  }
+  
+  /**
+   * Get the value of a `libgamma` error definition refered to
+   * by name, without allocating memory.
+   * 
+   * @param   name    The name of the definition associated with the error code,
+   *                  it does not need to be NUL-terminated.
+   * @param   length  The length of `name`.
+   * @return          The error code, zero if the name is `nullptr`
+   *                  or does not refer to a `libgamma` error.
+   */
+  int error_value(const char* name, size_t length) noexcept
+  {
+    size_t low = 0, high = LIBGAMMA_ERROR_NAME_COUNT, mid;
+    int cmp;
+    if (name == nullptr)
+      return 0;
+    while (low < high)
+      {
+	mid = low + (high - low) / 2;
+	cmp = strncmp(error_names[mid].name, name, length);
+	if ((cmp == 0) && (error_names[mid].name[length] != '\0'))
+	  cmp = 1;
+	if (cmp == 0)
+	  return error_names[mid].value;
+	if (cmp < 0)
+	  low = mid + 1;
+	else
+	  high = mid;
+      }
+    return 0;
+  }
+  
+  /**
+   * Get the value of a `libgamma` error definition refered
+   * to by name, without allocating memory.
+   * 
+   * @param   name  The name of the definition associated with the error code.
+   * @return        The error code, zero if the name is `nullptr`
+   *                or does not refer to a `libgamma` error.
+   */
+  int error_value(const char* name) noexcept
+  {
+    if (name == nullptr)
+      return 0;
+    return error_value(name, strlen(name));
+  }
+  
+  
+  /**
+   * Store the result of `strerror_r` in a buffer, for the
+   * XSI-compliant version, which returns an error code.
+   * 
+   * @param  r       The return value of `strerror_r`.
+   * @param  buffer  The buffer given to `strerror_r`.
+   */
+  static void __attribute__((unused)) strerror_result(int r, char* buffer)
+  {
+    if (r != 0)
+      *buffer = '\0';
+  }
+  
+  /**
+   * Store the result of `strerror_r` in a buffer, for the
+   * GNU version, which may return a static string instead.
+   * 
+   * @param  r       The return value of `strerror_r`.
+   * @param  buffer  The buffer given to `strerror_r`.
+   */
+  static void __attribute__((unused)) strerror_result(char* r, char* buffer)
+  {
+    if (r != buffer)
+      {
+	strncpy(buffer, r, LIBGAMMA_ERROR_MESSAGE_SIZE - 1);
+	buffer[LIBGAMMA_ERROR_MESSAGE_SIZE - 1] = '\0';
+      }
   }
   
 
@@ -89,7 +355,17 @@ namespace libgamma
   LibgammaException::LibgammaException(int error_code) throw() :
     error_code(error_code)
   {
-    /* Do nothing. */
+    const char* name;
+    /* Resolve the message now, `strerror` is not thread-safe
+     * and `what` may be called any number of times. */
+    if (error_code < 0)
+      {
+	name = error_name(error_code);
+	strncpy(this->message, name == nullptr ? "" : name, LIBGAMMA_ERROR_MESSAGE_SIZE - 1);
+	this->message[LIBGAMMA_ERROR_MESSAGE_SIZE - 1] = '\0';
+      }
+    else
+      strerror_result(strerror_r(error_code, this->message, LIBGAMMA_ERROR_MESSAGE_SIZE), this->message);
   }
   
   /**
@@ -105,10 +381,7 @@ namespace libgamma
    */
   const char* LibgammaException::what() const throw()
   {
-    if (this->error_code < 0)
-      return libgamma_name_of_error(this->error_code);
-    else
-      return strerror(this->error_code);
+    return this->message;
   }
   
 #ifdef __GCC__
@@ -126,9 +399,33 @@ namespace libgamma
    */
   LibgammaException create_error(int error_code)
   {
-    if (error_code == LIBGAMMA_ERRNO_SET)
-      error_code = errno;
-    return LibgammaException(error_code);
+    return LibgammaException(resolve_error(error_code));
+  }
+  
+  /**
+   * Resolve an error code that may be `LIBGAMMA_ERRNO_SET`
+   * into the value of `errno`.
+   * 
+   * @param   error_code  The error code.
+   * @return              `errno` if `error_code` is `LIBGAMMA_ERRNO_SET`,
+   *                      otherwise `error_code`.
+   */
+  int resolve_error(int error_code) noexcept
+  {
+    return error_code == LIBGAMMA_ERRNO_SET ? errno : error_code;
+  }
+  
+  /**
+   * Print an error, as `perror` does, and abort the process.
+   * This is used instead of throwing exceptions if the
+   * library is compiled without support for exceptions.
+   * 
+   * @param  error_code  The error code.
+   */
+  void fatal_error(int error_code) noexcept
+  {
+    libgamma_perror("libgammamm", error_code);
+    abort();
   }
   
   
@@ -37,6 +37,32 @@
 #endif
 
 
+/**
+ * Defined if the library is compiled with support for exceptions,
+ * that is, without `-fno-exceptions`.
+ */
+#if defined(__EXCEPTIONS) || defined(__cpp_exceptions)
+# define LIBGAMMA_HAVE_EXCEPTIONS
+#endif
+
+/**
+ * Throw an exception for an error code, or, if the library is compiled
+ * without support for exceptions, print the error and abort the process.
+ * 
+ * @param  ERROR  The error code.
+ */
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+# define __LIBGAMMA_THROW(ERROR)  throw create_error(ERROR)
+#else
+# define __LIBGAMMA_THROW(ERROR)  fatal_error(ERROR)
+#endif
+
+/**
+ * The size of the buffer for the message of a `LibgammaException`.
+ */
+#define LIBGAMMA_ERROR_MESSAGE_SIZE  128
+
+
 
 namespace libgamma
 {
@@ -88,6 +114,40 @@ namespace libgamma
    */
   int value_of_error(const std::string* name) __attribute__((pure));
   
+  /**
+   * Get the name of the definition associated with a `libgamma` error
+   * code, without allocating memory. Errors that this library does
+   * not know about are looked up in `libgamma`.
+   * 
+   * @param   value  The error code.
+   * @return         The name of the definition associated with the error code,
+   *                 `nullptr` if the error code does not exist. The string is
+   *                 statically allocated and must not be freed.
+   */
+  const char* error_name(int value) noexcept;
+  
+  /**
+   * Get the value of a `libgamma` error definition refered to
+   * by name, without allocating memory.
+   * 
+   * @param   name    The name of the definition associated with the error code,
+   *                  it does not need to be NUL-terminated.
+   * @param   length  The length of `name`.
+   * @return          The error code, zero if the name is `nullptr`
+   *                  or does not refer to a `libgamma` error.
+   */
+  int error_value(const char* name, size_t length) noexcept __attribute__((pure));
+  
+  /**
+   * Get the value of a `libgamma` error definition refered
+   * to by name, without allocating memory.
+   * 
+   * @param   name  The name of the definition associated with the error code.
+   * @return        The error code, zero if the name is `nullptr`
+   *                or does not refer to a `libgamma` error.
+   */
+  int error_value(const char* name) noexcept __attribute__((pure));
+  
   
   /**
    * Class for `group_gid`.
@@ -110,6 +170,8 @@ namespace libgamma
   /**
    * Group that the user needs to be a member of if
    * `LIBGAMMA_DEVICE_REQUIRE_GROUP` is returned.
+   * This is shared by the whole process, see
+   * `Context::group_gid` for a per-thread alternative.
    */
   extern GroupGid group_gid;
   
@@ -137,6 +199,8 @@ namespace libgamma
    * `LIBGAMMA_DEVICE_REQUIRE_GROUP` is returned,
    * `nullptr` if the name of the group
    * `libgamma::group_gid` cannot be determined.
+   * This is shared by the whole process, see
+   * `Context::group_name` for a per-thread alternative.
    */
   extern GroupName group_name;
   
@@ -162,13 +226,19 @@ namespace libgamma
     /**
      * Get the error as a string.
      */
-    virtual const char* what() const throw();
+    virtual const char* what() const throw() __attribute__((const));
     
     /**
      * The error code.
      */
     int error_code;
     
+    /**
+     * The message returned by `what`, resolved
+     * when the exception is created.
+     */
+    char message[LIBGAMMA_ERROR_MESSAGE_SIZE];
+    
   };
   
   
@@ -182,6 +252,72 @@ namespace libgamma
    */
   LibgammaException create_error(int error_code);
   
+  /**
+   * Resolve an error code that may be `LIBGAMMA_ERRNO_SET`
+   * into the value of `errno`.
+   * 
+   * @param   error_code  The error code.
+   * @return              `errno` if `error_code` is `LIBGAMMA_ERRNO_SET`,
+   *                      otherwise `error_code`.
+   */
+  int resolve_error(int error_code) noexcept __attribute__((pure));
+  
+  /**
+   * Print an error, as `perror` does, and abort the process.
+   * This is used instead of throwing exceptions if the
+   * library is compiled without support for exceptions.
+   * 
+   * @param  error_code  The error code.
+   */
+  void fatal_error(int error_code) noexcept __attribute__((noreturn));
+  
+  
+  /**
+   * The result of an operation that does not throw
+   * exceptions: an error code and, on success, a value.
+   */
+  template <typename T>
+  class Result
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  result_error  Zero on success, otherwise the error code.
+     * @param  result_value  The value, should be value-initialised on failure.
+     */
+    Result(int result_error, T result_value) noexcept :
+      error(result_error),
+      value(result_value)
+    {
+      /* Do nothing. */
+    }
+    
+    /**
+     * Check whether the operation was successful.
+     * 
+     * @return  Whether `error` is zero.
+     */
+    bool ok() const noexcept
+    {
+      return this->error == 0;
+    }
+    
+    
+    
+    /**
+     * Zero on success, otherwise the error code, which may
+     * come from `errno.h` or be a `libgamma` error code.
+     */
+    int error;
+    
+    /**
+     * The value, valid only on success.
+     */
+    T value;
+    
+  };
+  
 }
 
 
@@ -0,0 +1,142 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-executor.hh"
+
+
+namespace libgamma
+{
+  /**
+   * Constructor.
+   * 
+   * @param  threads  The number of worker threads, zero for
+   *                  the number of hardware threads.
+   */
+  WorkerPool::WorkerPool(size_t threads) :
+    queues(),
+    ready(),
+    workers(),
+    stopping(false),
+    mutex(),
+    condition()
+  {
+    size_t i;
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+      threads = 2;
+    for (i = 0; i < threads; i++)
+      this->workers.push_back(std::thread(&WorkerPool::run, this));
+  }
+  
+  /**
+   * Destructor, runs all submitted tasks
+   * and then stops the workers.
+   */
+  WorkerPool::~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->stopping = true;
+      this->condition.notify_all();
+    }
+    for (std::thread& worker : this->workers)
+      worker.join();
+  }
+  
+  /**
+   * Submit a task.
+   * 
+   * @param  key   The serial queue to run the task in, for example
+   *               the object that the task operates on.
+   * @param  task  The task, it must not throw exceptions.
+   */
+  void WorkerPool::submit(const void* key, std::function<void()> task)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->queues.find(key);
+    if (it != this->queues.end())
+      {
+	/* The key is ready or running, and will be picked up again. */
+	it->second.push_back(std::move(task));
+	return;
+      }
+    this->queues[key].push_back(std::move(task));
+    this->ready.push_back(key);
+    this->condition.notify_one();
+  }
+  
+  /**
+   * Get the number of worker threads.
+   * 
+   * @return  The number of worker threads.
+   */
+  size_t WorkerPool::size() const
+  {
+    return this->workers.size();
+  }
+  
+  /**
+   * The function that runs on the worker threads.
+   */
+  void WorkerPool::run()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    std::function<void()> task;
+    const void* key;
+    for (;;)
+      {
+	this->condition.wait(lock, [this] { return this->stopping || !(this->ready.empty()); });
+	if (this->ready.empty())
+	  break;
+	
+	key = this->ready.front();
+	this->ready.pop_front();
+	std::deque<std::function<void()>>& queue = this->queues[key];
+	task = std::move(queue.front());
+	queue.pop_front();
+	
+	lock.unlock();
+	task();
+	task = nullptr;
+	lock.lock();
+	
+	/* The key could not have been erased while the task ran. */
+	if (this->queues[key].empty())
+	  this->queues.erase(key);
+	else
+	  {
+	    this->ready.push_back(key);
+	    this->condition.notify_one();
+	  }
+      }
+  }
+  
+  /**
+   * Get the pool that is used when no pool is specified.
+   * It is created on first use and never destroyed.
+   * 
+   * @return  The shared pool.
+   */
+  WorkerPool* WorkerPool::shared()
+  {
+    static WorkerPool* pool = new WorkerPool();
+    return pool;
+  }
+  
+}
+
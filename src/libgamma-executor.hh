@@ -0,0 +1,146 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_EXECUTOR_HH
+#define LIBGAMMA_EXECUTOR_HH
+
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * A bounded pool of worker threads that runs tasks in
+   * serial queues. Tasks submitted with the same key are
+   * run in the order they were submitted and never at the
+   * same time, whilst tasks with different keys run in
+   * parallel, on at most as many threads as the pool has.
+   */
+  class WorkerPool
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  threads  The number of worker threads, zero for
+     *                  the number of hardware threads.
+     */
+    WorkerPool(size_t threads = 0);
+    
+    /**
+     * Destructor, runs all submitted tasks
+     * and then stops the workers.
+     */
+    ~WorkerPool();
+    
+    /**
+     * Submit a task.
+     * 
+     * @param  key   The serial queue to run the task in, for example
+     *               the object that the task operates on.
+     * @param  task  The task, it must not throw exceptions.
+     */
+    void submit(const void* key, std::function<void()> task);
+    
+    /**
+     * Get the number of worker threads.
+     * 
+     * @return  The number of worker threads.
+     */
+    size_t size() const __attribute__((pure));
+    
+    /**
+     * Get the pool that is used when no pool is specified.
+     * It is created on first use and never destroyed.
+     * 
+     * @return  The shared pool.
+     */
+    static WorkerPool* shared();
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    WorkerPool(const WorkerPool&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    WorkerPool& operator =(const WorkerPool&) = delete;
+    
+    /**
+     * The function that runs on the worker threads.
+     */
+    void run();
+    
+    
+    
+    /**
+     * The pending tasks for each key that has
+     * pending or running tasks.
+     */
+    std::unordered_map<const void*, std::deque<std::function<void()>>> queues;
+    
+    /**
+     * Keys that have pending tasks and no running task.
+     */
+    std::deque<const void*> ready;
+    
+    /**
+     * The worker threads.
+     */
+    std::vector<std::thread> workers;
+    
+    /**
+     * Whether the workers shall stop when there is no more work.
+     */
+    bool stopping;
+    
+    /**
+     * Guards the queues.
+     */
+    std::mutex mutex;
+    
+    /**
+     * Wakes workers when a key becomes ready.
+     */
+    std::condition_variable condition;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -20,6 +20,7 @@
 #include "libgamma-error.hh"
 
 #include <cstdlib>
+#include <cerrno>
 
 
 namespace libgamma
@@ -38,22 +39,19 @@ namespace libgamma
    */
   std::vector<int> list_methods(int operation)
   {
-    int* methods = (int*)malloc(LIBGAMMA_METHOD_COUNT * sizeof(int));
-    size_t n, i;
+    int methods[LIBGAMMA_METHOD_COUNT];
     std::vector<int> rc;
+    size_t n;
     
     n = libgamma_list_methods(methods, LIBGAMMA_METHOD_COUNT, operation);
     if (n > LIBGAMMA_METHOD_COUNT)
       {
-	free(methods);
-	methods = (int*)malloc(n * sizeof(int));
-	libgamma_list_methods(methods, n, operation);
+	rc.resize(n);
+	libgamma_list_methods(rc.data(), n, operation);
+	return rc;
       }
     
-    for (i = 0; i < n; i++)
-      rc.push_back(methods[i]);
-    
-    free(methods);
+    rc.assign(methods, methods + n);
     return rc;
   }
   
@@ -137,9 +135,8 @@ namespace libgamma
    */
   std::string behex_edid_lowercase(const unsigned char* edid, size_t length)
   {
-    char* cstr = libgamma_behex_edid_lowercase(edid, length);
-    std::string rc = std::string(cstr);
-    free(cstr);
+    std::string rc;
+    behex_edid(edid, length, &rc, false);
     return rc;
   }
   
@@ -152,9 +149,8 @@ namespace libgamma
    */
   std::string behex_edid_uppercase(const unsigned char* edid, size_t length)
   {
-    char* cstr = libgamma_behex_edid_uppercase(edid, length);
-    std::string rc = std::string(cstr);
-    free(cstr);
+    std::string rc;
+    behex_edid(edid, length, &rc, true);
     return rc;
   }
   
@@ -172,6 +168,164 @@ namespace libgamma
   }
   
   
+  /**
+   * Lowercase hexadecimal digits.
+   */
+  static const char hex_lowercase[] = "0123456789abcdef";
+  
+  /**
+   * Uppercase hexadecimal digits.
+   */
+  static const char hex_uppercase[] = "0123456789ABCDEF";
+  
+  /**
+   * The values of hexadecimal digits, indexed by
+   * character, -1 for characters that are not
+   * hexadecimal digits.
+   */
+  class HexValues
+  {
+  public:
+    /**
+     * Constructor, fills the table.
+     */
+    HexValues()
+    {
+      int c;
+      for (c = 0; c < 256; c++)
+	this->values[c] = -1;
+      for (c = 0; c < 10; c++)
+	this->values['0' + c] = (signed char)c;
+      for (c = 0; c < 6; c++)
+	{
+	  this->values['a' + c] = (signed char)(10 + c);
+	  this->values['A' + c] = (signed char)(10 + c);
+	}
+    }
+    
+    /**
+     * The table.
+     */
+    signed char values[256];
+    
+  };
+  
+  /**
+   * The values of hexadecimal digits.
+   */
+  static const HexValues hex_values;
+  
+  /**
+   * Encode bytes as hexadecimal, without NUL-termination.
+   * 
+   * @param  data    The bytes.
+   * @param  length  The number of bytes.
+   * @param  output  Output buffer, `2 * length` characters.
+   * @param  digits  The digits to use.
+   */
+  static void encode_hex(const unsigned char* data, size_t length, char* output, const char* digits)
+  {
+    size_t i;
+    for (i = 0; i < length; i++)
+      {
+	output[2 * i + 0] = digits[data[i] >> 4];
+	output[2 * i + 1] = digits[data[i] & 15];
+      }
+  }
+  
+  /**
+   * Convert a raw representation of an EDID to a hexadecimal
+   * representation, into a caller-supplied buffer.
+   * 
+   * @param   edid         The EDID in raw representation.
+   * @param   length       The length of `edid`.
+   * @param   output       Output buffer for the EDID in hexadecimal representation,
+   *                       it will be NUL-terminated.
+   * @param   output_size  The size of `output`, must be at least `2 * length + 1`,
+   *                       otherwise `ERANGE` is thrown.
+   * @param   uppercase    Whether to use uppercase rather than lowercase letters.
+   * @return               The length of the hexadecimal representation, `2 * length`.
+   */
+  size_t behex_edid(const unsigned char* edid, size_t length, char* output, size_t output_size, bool uppercase)
+  {
+    if ((output_size == 0) || (length > (output_size - 1) / 2))
+      throw create_error(ERANGE);
+    encode_hex(edid, length, output, uppercase ? hex_uppercase : hex_lowercase);
+    output[2 * length] = '\0';
+    return 2 * length;
+  }
+  
+  /**
+   * Convert a raw representation of an EDID to a hexadecimal representation,
+   * into a string whose allocation is reused if it is large enough.
+   * 
+   * @param  edid       The EDID in raw representation.
+   * @param  length     The length of `edid`.
+   * @param  output     Output parameter for the EDID in hexadecimal representation.
+   * @param  uppercase  Whether to use uppercase rather than lowercase letters.
+   */
+  void behex_edid(const unsigned char* edid, size_t length, std::string* output, bool uppercase)
+  {
+    output->resize(2 * length);
+    if (length > 0)
+      encode_hex(edid, length, &((*output)[0]), uppercase ? hex_uppercase : hex_lowercase);
+  }
+  
+  /**
+   * Convert a hexadecimal representation of an EDID to a raw
+   * representation, into a caller-supplied buffer. Both lowercase
+   * and uppercase letters are accepted. `EINVAL` is thrown if the
+   * length of `edid` is odd or if it contains anything but
+   * hexadecimal digits.
+   * 
+   * @param   edid         The EDID in hexadecimal representation.
+   * @param   length       The length of `edid`.
+   * @param   output       Output buffer for the EDID in raw representation.
+   * @param   output_size  The size of `output`, must be at least `length / 2`,
+   *                       otherwise `ERANGE` is thrown.
+   * @return               The length of the raw representation, `length / 2`.
+   */
+  size_t unhex_edid(const char* edid, size_t length, unsigned char* output, size_t output_size)
+  {
+    const unsigned char* hex = (const unsigned char*)edid;
+    size_t i, n = length / 2;
+    int high, low, invalid = 0;
+    if ((length & 1) != 0)
+      throw create_error(EINVAL);
+    if (n > output_size)
+      throw create_error(ERANGE);
+    for (i = 0; i < n; i++)
+      {
+	high = hex_values.values[hex[2 * i + 0]];
+	low  = hex_values.values[hex[2 * i + 1]];
+	/* Check once at the end, the sign bit is set by any invalid digit. */
+	invalid |= high | low;
+	output[i] = (unsigned char)((high << 4) | (low & 15));
+      }
+    if (invalid < 0)
+      throw create_error(EINVAL);
+    return n;
+  }
+  
+  /**
+   * Convert a hexadecimal representation of an EDID to a raw
+   * representation, into a caller-supplied buffer. Both lowercase
+   * and uppercase letters are accepted. `EINVAL` is thrown if the
+   * length of `edid` is odd or if it contains anything but
+   * hexadecimal digits.
+   * 
+   * @param   edid         The EDID in hexadecimal representation.
+   * @param   output       Output buffer for the EDID in raw representation.
+   * @param   output_size  The size of `output`, must be at least `edid.size() / 2`,
+   *                       otherwise `ERANGE` is thrown.
+   * @return               The length of the raw representation, `edid.size() / 2`.
+   */
+  size_t unhex_edid(const std::string& edid, unsigned char* output, size_t output_size)
+  {
+    return unhex_edid(edid.data(), edid.size(), output, output_size);
+  }
+  
+  
   /**
    * Initialise a gamma ramp in the proper way that allows all adjustment
    * methods to read from and write to it without causing segmentation violation.
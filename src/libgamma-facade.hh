@@ -122,6 +122,64 @@ namespace libgamma
    */
   unsigned char* unhex_edid(const std::string edid);
   
+  /**
+   * Convert a raw representation of an EDID to a hexadecimal
+   * representation, into a caller-supplied buffer.
+   * 
+   * @param   edid         The EDID in raw representation.
+   * @param   length       The length of `edid`.
+   * @param   output       Output buffer for the EDID in hexadecimal representation,
+   *                       it will be NUL-terminated.
+   * @param   output_size  The size of `output`, must be at least `2 * length + 1`,
+   *                       otherwise `ERANGE` is thrown.
+   * @param   uppercase    Whether to use uppercase rather than lowercase letters.
+   * @return               The length of the hexadecimal representation, `2 * length`.
+   */
+  size_t behex_edid(const unsigned char* edid, size_t length, char* output, size_t output_size,
+		    bool uppercase = false);
+  
+  /**
+   * Convert a raw representation of an EDID to a hexadecimal representation,
+   * into a string whose allocation is reused if it is large enough.
+   * 
+   * @param  edid       The EDID in raw representation.
+   * @param  length     The length of `edid`.
+   * @param  output     Output parameter for the EDID in hexadecimal representation.
+   * @param  uppercase  Whether to use uppercase rather than lowercase letters.
+   */
+  void behex_edid(const unsigned char* edid, size_t length, std::string* output, bool uppercase = false);
+  
+  /**
+   * Convert a hexadecimal representation of an EDID to a raw
+   * representation, into a caller-supplied buffer. Both lowercase
+   * and uppercase letters are accepted. `EINVAL` is thrown if the
+   * length of `edid` is odd or if it contains anything but
+   * hexadecimal digits.
+   * 
+   * @param   edid         The EDID in hexadecimal representation.
+   * @param   length       The length of `edid`.
+   * @param   output       Output buffer for the EDID in raw representation.
+   * @param   output_size  The size of `output`, must be at least `length / 2`,
+   *                       otherwise `ERANGE` is thrown.
+   * @return               The length of the raw representation, `length / 2`.
+   */
+  size_t unhex_edid(const char* edid, size_t length, unsigned char* output, size_t output_size);
+  
+  /**
+   * Convert a hexadecimal representation of an EDID to a raw
+   * representation, into a caller-supplied buffer. Both lowercase
+   * and uppercase letters are accepted. `EINVAL` is thrown if the
+   * length of `edid` is odd or if it contains anything but
+   * hexadecimal digits.
+   * 
+   * @param   edid         The EDID in hexadecimal representation.
+   * @param   output       Output buffer for the EDID in raw representation.
+   * @param   output_size  The size of `output`, must be at least `edid.size() / 2`,
+   *                       otherwise `ERANGE` is thrown.
+   * @return               The length of the raw representation, `edid.size() / 2`.
+   */
+  size_t unhex_edid(const std::string& edid, unsigned char* output, size_t output_size);
+  
   
   /**
    * Initialise a gamma ramp in the proper way that allows all adjustment
@@ -256,6 +314,68 @@ namespace libgamma
    */
   GammaRamps<double>* gamma_rampsd_create(size_t red, size_t blue, size_t green);
   
+  
+  /**
+   * Initialise a gamma ramp from an arena. All channels are put
+   * in one block, aligned to `LIBGAMMA_ARENA_ALIGNMENT` bytes,
+   * and each channel starts on its own cache line.
+   * 
+   * Memory that `ramps` already owns is released once the new
+   * block has been allocated. If the allocation fails, `ramps`
+   * is left unchanged.
+   * 
+   * @param  ramps  The gamma ramp to initialise.
+   * @param  red    The size of the gamma ramp for the red channel.
+   * @param  green  The size of the gamma ramp for the green channel.
+   * @param  blue   The size of the gamma ramp for the blue channel.
+   * @param  arena  The arena to allocate from, `nullptr` for the shared arena.
+   */
+  template <typename T>
+  void gamma_ramps_allocate(GammaRamps<T>* ramps, size_t red, size_t green, size_t blue,
+			    RampArena* arena = nullptr)
+  {
+    size_t red_bytes = RampArena::padded(red * sizeof(T));
+    size_t green_bytes = RampArena::padded(green * sizeof(T));
+    size_t blue_bytes = RampArena::padded(blue * sizeof(T));
+    char* block;
+    if (arena == nullptr)
+      arena = RampArena::shared();
+    block = (char*)(arena->allocate(red_bytes + green_bytes + blue_bytes));
+    *ramps = GammaRamps<T>((T*)(void*)block,
+			   (T*)(void*)(block + red_bytes),
+			   (T*)(void*)(block + red_bytes + green_bytes),
+			   red, green, blue, RampDepth<T>::value, RAMP_OWNERSHIP_VIEW);
+    ramps->ownership = RAMP_OWNERSHIP_ARENA;
+    ramps->arena = arena;
+  }
+  
+  /**
+   * Create a gamma ramp from an arena. All channels are put
+   * in one block, aligned to `LIBGAMMA_ARENA_ALIGNMENT` bytes,
+   * and each channel starts on its own cache line.
+   * 
+   * @param   red    The size of the gamma ramp for the red channel.
+   * @param   green  The size of the gamma ramp for the green channel.
+   * @param   blue   The size of the gamma ramp for the blue channel.
+   * @param   arena  The arena to allocate from, `nullptr` for the shared arena.
+   * @return         The gamma ramp.
+   */
+  template <typename T>
+  GammaRamps<T>* gamma_ramps_allocate(size_t red, size_t green, size_t blue, RampArena* arena = nullptr)
+  {
+    GammaRamps<T>* ramps = new GammaRamps<T>();
+    try
+      {
+	gamma_ramps_allocate(ramps, red, green, blue, arena);
+      }
+    catch (...)
+      {
+	delete ramps;
+	throw;
+      }
+    return ramps;
+  }
+  
 }
 
 
@@ -0,0 +1,235 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-generate.hh"
+
+#include "libgamma-convert.hh"
+
+#include <cmath>
+#include <vector>
+
+
+/**
+ * The number of stops that are generated at a time. The
+ * specialised sizes must be multiples of this value.
+ */
+#define LIBGAMMA_GENERATE_BLOCK  256
+
+
+namespace libgamma
+{
+  /**
+   * Clamp a value to [0, 1].
+   * 
+   * @param   value  The value.
+   * @return         The value clamped to [0, 1].
+   */
+  static inline double clamp_unit(double value)
+  {
+    return value < 0 ? 0 : value > 1 ? 1 : value;
+  }
+  
+  
+  /**
+   * Kernels for ramps whose size is known at compile time,
+   * so that all loops have constant trip counts and the
+   * position of each stop is a multiplication by a constant.
+   */
+  template <size_t N>
+  class FixedRampKernel
+  {
+  public:
+    /**
+     * Get the natural logarithms of the positions,
+     * `i / (N - 1)`, of the stops. The table is built
+     * on first use and shared by all element types.
+     * 
+     * @return  The logarithms, the first element is -inf.
+     */
+    static const double* logarithms()
+    {
+      static const std::vector<double> table = FixedRampKernel<N>::make_logarithms();
+      return table.data();
+    }
+    
+    /**
+     * Fill a ramp with a straight line.
+     * 
+     * @param  ramp   The stops to fill, `N` elements.
+     * @param  start  The value of the first stop.
+     * @param  end    The value of the last stop.
+     */
+    template <typename T>
+    static void linear(T* ramp, double start, double end)
+    {
+      const double step = (end - start) / (double)(N - 1);
+      double block[LIBGAMMA_GENERATE_BLOCK];
+      size_t offset, i;
+      for (offset = 0; offset < N; offset += LIBGAMMA_GENERATE_BLOCK)
+	{
+	  for (i = 0; i < LIBGAMMA_GENERATE_BLOCK; i++)
+	    block[i] = clamp_unit(start + (double)(offset + i) * step);
+	  convert_stops(block, ramp + offset, LIBGAMMA_GENERATE_BLOCK);
+	}
+    }
+    
+    /**
+     * Fill a ramp with a power curve, using the table of
+     * logarithms so that only an exponentiation per stop
+     * is needed.
+     * 
+     * @param  ramp      The stops to fill, `N` elements.
+     * @param  exponent  The exponent.
+     */
+    template <typename T>
+    static void power(T* ramp, double exponent)
+    {
+      const double* logs = FixedRampKernel<N>::logarithms();
+      double block[LIBGAMMA_GENERATE_BLOCK];
+      size_t offset, i;
+      for (offset = 0; offset < N; offset += LIBGAMMA_GENERATE_BLOCK)
+	{
+	  for (i = 0; i < LIBGAMMA_GENERATE_BLOCK; i++)
+	    block[i] = clamp_unit(std::exp(exponent * logs[offset + i]));
+	  if (offset == 0)
+	    block[0] = clamp_unit(std::pow(0.0, exponent));
+	  convert_stops(block, ramp + offset, LIBGAMMA_GENERATE_BLOCK);
+	}
+    }
+  
+  private:
+    /**
+     * Build the table for `logarithms`.
+     * 
+     * @return  The table.
+     */
+    static std::vector<double> make_logarithms()
+    {
+      std::vector<double> table(N);
+      size_t i;
+      for (i = 0; i < N; i++)
+	table[i] = std::log((double)i / (double)(N - 1));
+      return table;
+    }
+    
+  };
+  
+  
+  /**
+   * Fill a ramp of any size with a straight line.
+   * 
+   * @param  ramp   The stops to fill.
+   * @param  n      The number of stops.
+   * @param  start  The value of the first stop.
+   * @param  end    The value of the last stop.
+   */
+  template <typename T>
+  static void generic_linear(T* ramp, size_t n, double start, double end)
+  {
+    const double step = n > 1 ? (end - start) / (double)(n - 1) : 0;
+    double block[LIBGAMMA_GENERATE_BLOCK];
+    size_t offset, m, i;
+    for (offset = 0; offset < n; offset += m)
+      {
+	m = n - offset < LIBGAMMA_GENERATE_BLOCK ? n - offset : LIBGAMMA_GENERATE_BLOCK;
+	for (i = 0; i < m; i++)
+	  block[i] = clamp_unit(start + (double)(offset + i) * step);
+	convert_stops(block, ramp + offset, m);
+      }
+  }
+  
+  /**
+   * Fill a ramp of any size with a power curve.
+   * 
+   * @param  ramp      The stops to fill.
+   * @param  n         The number of stops.
+   * @param  exponent  The exponent.
+   */
+  template <typename T>
+  static void generic_power(T* ramp, size_t n, double exponent)
+  {
+    const double step = n > 1 ? 1 / (double)(n - 1) : 0;
+    double block[LIBGAMMA_GENERATE_BLOCK];
+    size_t offset, m, i;
+    for (offset = 0; offset < n; offset += m)
+      {
+	m = n - offset < LIBGAMMA_GENERATE_BLOCK ? n - offset : LIBGAMMA_GENERATE_BLOCK;
+	for (i = 0; i < m; i++)
+	  block[i] = clamp_unit(std::pow((double)(offset + i) * step, exponent));
+	convert_stops(block, ramp + offset, m);
+      }
+  }
+  
+  
+  /**
+   * Fill a gamma ramp with a straight line.
+   * 
+   * @param  ramp   The ramp to fill.
+   * @param  start  The value of the first stop, 0 for the minimum value.
+   * @param  end    The value of the last stop, 1 for the maximum value.
+   */
+  template <typename T>
+  void ramp_linear(Ramp<T>* ramp, double start, double end)
+  {
+    switch (ramp->size)
+      {
+      case 256:   FixedRampKernel<256>::linear(ramp->ramp, start, end);   break;
+      case 1024:  FixedRampKernel<1024>::linear(ramp->ramp, start, end);  break;
+      case 4096:  FixedRampKernel<4096>::linear(ramp->ramp, start, end);  break;
+      default:
+	generic_linear(ramp->ramp, ramp->size, start, end);
+	break;
+      }
+  }
+  
+  /**
+   * Fill a gamma ramp with a power curve, `x ^ exponent`
+   * for `x` going from 0 to 1.
+   * 
+   * @param  ramp      The ramp to fill.
+   * @param  exponent  The exponent, the reciprocal of the gamma.
+   */
+  template <typename T>
+  void ramp_power(Ramp<T>* ramp, double exponent)
+  {
+    switch (ramp->size)
+      {
+      case 256:   FixedRampKernel<256>::power(ramp->ramp, exponent);   break;
+      case 1024:  FixedRampKernel<1024>::power(ramp->ramp, exponent);  break;
+      case 4096:  FixedRampKernel<4096>::power(ramp->ramp, exponent);  break;
+      default:
+	generic_power(ramp->ramp, ramp->size, exponent);
+	break;
+      }
+  }
+  
+  
+#define __LIBGAMMA_GENERATE(T)								\
+  template void ramp_linear<T>(Ramp<T>* ramp, double start, double end);		\
+  template void ramp_power<T>(Ramp<T>* ramp, double exponent)
+  
+  __LIBGAMMA_GENERATE(uint8_t);
+  __LIBGAMMA_GENERATE(uint16_t);
+  __LIBGAMMA_GENERATE(uint32_t);
+  __LIBGAMMA_GENERATE(uint64_t);
+  __LIBGAMMA_GENERATE(float);
+  __LIBGAMMA_GENERATE(double);
+  
+#undef __LIBGAMMA_GENERATE
+
+}
+
@@ -0,0 +1,126 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_GENERATE_HH
+#define LIBGAMMA_GENERATE_HH
+
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /*
+   * The generators below have kernels specialised at compile
+   * time for ramps with 256, 1024 and 4096 stops, which are
+   * the gamma ramp sizes used by almost all CRTC:s, and fall
+   * back to a generic kernel for other sizes. Values are
+   * calculated in double precision, clamped to [0, 1] and
+   * rounded to the nearest value of the element type.
+   */
+  
+  /**
+   * Fill a gamma ramp with a straight line.
+   * 
+   * @param  ramp   The ramp to fill.
+   * @param  start  The value of the first stop, 0 for the minimum value.
+   * @param  end    The value of the last stop, 1 for the maximum value.
+   */
+  template <typename T>
+  void ramp_linear(Ramp<T>* ramp, double start, double end);
+  
+  /**
+   * Fill a gamma ramp with the identity mapping.
+   * 
+   * @param  ramp  The ramp to fill.
+   */
+  template <typename T>
+  void ramp_identity(Ramp<T>* ramp)
+  {
+    ramp_linear(ramp, 0, 1);
+  }
+  
+  /**
+   * Fill a gamma ramp with a power curve, `x ^ exponent`
+   * for `x` going from 0 to 1.
+   * 
+   * @param  ramp      The ramp to fill.
+   * @param  exponent  The exponent, the reciprocal of the gamma.
+   */
+  template <typename T>
+  void ramp_power(Ramp<T>* ramp, double exponent);
+  
+  
+  /**
+   * Fill all channels of gamma ramps with the identity mapping.
+   * 
+   * @param  ramps  The gamma ramps to fill.
+   */
+  template <typename T>
+  void gamma_ramps_identity(GammaRamps<T>* ramps)
+  {
+    ramp_linear(&(ramps->red), 0, 1);
+    ramp_linear(&(ramps->green), 0, 1);
+    ramp_linear(&(ramps->blue), 0, 1);
+  }
+  
+  /**
+   * Fill all channels of gamma ramps with a straight line.
+   * 
+   * @param  ramps  The gamma ramps to fill.
+   * @param  start  The value of the first stop, 0 for the minimum value.
+   * @param  end    The value of the last stop, 1 for the maximum value.
+   */
+  template <typename T>
+  void gamma_ramps_linear(GammaRamps<T>* ramps, double start, double end)
+  {
+    ramp_linear(&(ramps->red), start, end);
+    ramp_linear(&(ramps->green), start, end);
+    ramp_linear(&(ramps->blue), start, end);
+  }
+  
+  /**
+   * Fill the channels of gamma ramps with power curves.
+   * 
+   * @param  ramps  The gamma ramps to fill.
+   * @param  red    The exponent for the red channel.
+   * @param  green  The exponent for the green channel.
+   * @param  blue   The exponent for the blue channel.
+   */
+  template <typename T>
+  void gamma_ramps_power(GammaRamps<T>* ramps, double red, double green, double blue)
+  {
+    ramp_power(&(ramps->red), red);
+    ramp_power(&(ramps->green), green);
+    ramp_power(&(ramps->blue), blue);
+  }
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,73 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-hash.hh"
+
+#include <cstring>
+
+
+namespace libgamma
+{
+  /**
+   * Mix the bits of a word in the hash state.
+   * 
+   * @param   state  The hash state.
+   * @param   word   The word to add to the state.
+   * @return         The new hash state.
+   */
+  static inline uint64_t hash_mix(uint64_t state, uint64_t word)
+  {
+    state ^= word;
+    state *= 0x9E3779B97F4A7C15ULL;
+    state ^= state >> 32;
+    return state;
+  }
+  
+  /**
+   * Calculate a fast, non-cryptographic, 64-bit hash of a
+   * memory region. Eight bytes are consumed at a time.
+   * 
+   * @param   data  The memory region.
+   * @param   n     The size of the memory region, in bytes.
+   * @param   seed  The hash of the preceding data, if the
+   *                hash shall cover multiple regions.
+   * @return        The hash.
+   */
+  uint64_t hash_bytes(const void* data, size_t n, uint64_t seed)
+  {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t state = hash_mix(seed, n);
+    uint64_t word;
+    size_t i;
+    for (i = 0; i + 8 <= n; i += 8)
+      {
+	memcpy(&word, bytes + i, 8);
+	state = hash_mix(state, word);
+      }
+    if (i < n)
+      {
+	word = 0;
+	memcpy(&word, bytes + i, n - i);
+	state = hash_mix(state, word);
+      }
+    state ^= state >> 29;
+    state *= 0xBF58476D1CE4E5B9ULL;
+    return state ^ (state >> 32);
+  }
+  
+}
+
@@ -0,0 +1,54 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_HASH_HH
+#define LIBGAMMA_HASH_HH
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * Calculate a fast, non-cryptographic, 64-bit hash of a
+   * memory region. Eight bytes are consumed at a time.
+   * 
+   * @param   data  The memory region.
+   * @param   n     The size of the memory region, in bytes.
+   * @param   seed  The hash of the preceding data, if the
+   *                hash shall cover multiple regions.
+   * @return        The hash.
+   */
+  uint64_t hash_bytes(const void* data, size_t n, uint64_t seed = 0) __attribute__((pure));
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,192 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-mailbox.hh"
+
+#include "libgamma-facade.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <utility>
+
+
+namespace libgamma
+{
+  /**
+   * Constructor, starts the writer thread.
+   * 
+   * @param  target  The CRTC to apply the gamma ramps to.
+   */
+  template <typename T>
+  GammaMailbox<T>::GammaMailbox(CRTC* target) :
+    crtc(target),
+    submitted(0),
+    coalesced(0),
+    applied(0),
+    failed(0),
+    error(0),
+    slot(nullptr),
+    stopping(false),
+    mutex(),
+    condition(),
+    writer()
+  {
+    this->writer = std::thread(&GammaMailbox<T>::run, this);
+  }
+  
+  /**
+   * Destructor, applies the pending gamma
+   * ramps, if any, and stops the writer.
+   */
+  template <typename T>
+  GammaMailbox<T>::~GammaMailbox()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->stopping = true;
+    }
+    this->condition.notify_all();
+    this->writer.join();
+  }
+  
+  /**
+   * Submit gamma ramps, they are copied into a frame
+   * allocated from the shared `RampArena`.
+   * 
+   * @param  ramps  The gamma ramps to apply.
+   */
+  template <typename T>
+  void GammaMailbox<T>::submit(const GammaRamps<T>* ramps)
+  {
+    GammaRamps<T>* frame = gamma_ramps_allocate<T>(ramps->red.size, ramps->green.size, ramps->blue.size);
+    memcpy(frame->red.ramp, ramps->red.ramp, ramps->red.size * sizeof(T));
+    memcpy(frame->green.ramp, ramps->green.ramp, ramps->green.size * sizeof(T));
+    memcpy(frame->blue.ramp, ramps->blue.ramp, ramps->blue.size * sizeof(T));
+    this->publish(frame);
+  }
+  
+  /**
+   * Submit gamma ramps without copying them.
+   * 
+   * @param  ramps  The gamma ramps to apply, they are moved into the mailbox.
+   */
+  template <typename T>
+  void GammaMailbox<T>::submit(GammaRamps<T>&& ramps)
+  {
+    this->publish(new GammaRamps<T>(std::move(ramps)));
+  }
+  
+  /**
+   * Wait until all submitted gamma ramps have been
+   * applied, have failed, or have been replaced.
+   */
+  template <typename T>
+  void GammaMailbox<T>::flush()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->condition.wait(lock, [this]
+			 {
+			   return this->coalesced + this->applied + this->failed >= this->submitted;
+			 });
+  }
+  
+  /**
+   * Put gamma ramps in the slot.
+   * 
+   * @param  ramps  The gamma ramps, the mailbox takes ownership of them.
+   */
+  template <typename T>
+  void GammaMailbox<T>::publish(GammaRamps<T>* ramps)
+  {
+    GammaRamps<T>* stale;
+    this->submitted++;
+    stale = this->slot.exchange(ramps, std::memory_order_acq_rel);
+    if (stale != nullptr)
+      {
+	/* The writer never saw these, they are dropped. */
+	this->coalesced++;
+	delete stale;
+      }
+    else
+      {
+	/* Take the lock so the writer cannot miss the wake-up between
+	 * finding the slot empty and starting to wait. */
+	std::lock_guard<std::mutex> lock(this->mutex);
+      }
+    this->condition.notify_all();
+  }
+  
+  /**
+   * The function that runs on the writer thread.
+   */
+  template <typename T>
+  void GammaMailbox<T>::run()
+  {
+    GammaRamps<T>* ramps;
+    for (;;)
+      {
+	{
+	  std::unique_lock<std::mutex> lock(this->mutex);
+	  this->condition.wait(lock, [this]
+			       {
+				 return this->stopping || (this->slot.load(std::memory_order_acquire) != nullptr);
+			       });
+	}
+	ramps = this->slot.exchange(nullptr, std::memory_order_acq_rel);
+	if (ramps == nullptr)
+	  break;
+	
+	try
+	  {
+	    this->crtc->set_gamma(ramps);
+	    this->applied++;
+	  }
+	catch (const LibgammaException& e)
+	  {
+	    this->error = e.error_code;
+	    this->failed++;
+	  }
+	catch (const std::bad_alloc&)
+	  {
+	    this->error = ENOMEM;
+	    this->failed++;
+	  }
+	delete ramps;
+	
+	{
+	  std::lock_guard<std::mutex> lock(this->mutex);
+	}
+	this->condition.notify_all();
+      }
+  }
+  
+  
+#define __LIBGAMMA_MAILBOX(T)			\
+  template class GammaMailbox<T>
+  
+  __LIBGAMMA_MAILBOX(uint8_t);
+  __LIBGAMMA_MAILBOX(uint16_t);
+  __LIBGAMMA_MAILBOX(uint32_t);
+  __LIBGAMMA_MAILBOX(uint64_t);
+  __LIBGAMMA_MAILBOX(float);
+  __LIBGAMMA_MAILBOX(double);
+  
+#undef __LIBGAMMA_MAILBOX
+
+}
+
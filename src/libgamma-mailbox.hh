@@ -0,0 +1,183 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_MAILBOX_HH
+#define LIBGAMMA_MAILBOX_HH
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * A single-slot mailbox of gamma ramps for a CRTC, with a
+   * writer thread that applies the ramps to the CRTC.
+   * 
+   * Submitting ramps replaces any ramps that the writer has not
+   * picked up yet, so the writer always applies the newest ramps
+   * and never falls behind, however fast ramps are submitted.
+   * The slot is an atomic pointer, so submitting never waits for
+   * the writer. The CRTC must not be used by anyone else whilst
+   * the mailbox exists.
+   */
+  template <typename T>
+  class GammaMailbox
+  {
+  public:
+    /**
+     * Constructor, starts the writer thread.
+     * 
+     * @param  target  The CRTC to apply the gamma ramps to.
+     */
+    GammaMailbox(CRTC* target);
+    
+    /**
+     * Destructor, applies the pending gamma
+     * ramps, if any, and stops the writer.
+     */
+    ~GammaMailbox();
+    
+    /**
+     * Submit gamma ramps, they are copied into a frame
+     * allocated from the shared `RampArena`.
+     * 
+     * @param  ramps  The gamma ramps to apply.
+     */
+    void submit(const GammaRamps<T>* ramps);
+    
+    /**
+     * Submit gamma ramps without copying them.
+     * 
+     * @param  ramps  The gamma ramps to apply, they are moved into the mailbox.
+     */
+    void submit(GammaRamps<T>&& ramps);
+    
+    /**
+     * Wait until all submitted gamma ramps have been
+     * applied, have failed, or have been replaced.
+     */
+    void flush();
+    
+    
+    
+    /**
+     * The CRTC the gamma ramps are applied to.
+     */
+    CRTC* crtc;
+    
+    /**
+     * The number of submitted gamma ramps.
+     */
+    std::atomic<uint64_t> submitted;
+    
+    /**
+     * The number of submitted gamma ramps that were replaced
+     * by newer gamma ramps before they were applied.
+     */
+    std::atomic<uint64_t> coalesced;
+    
+    /**
+     * The number of gamma ramps that have been applied.
+     */
+    std::atomic<uint64_t> applied;
+    
+    /**
+     * The number of gamma ramps that could not be applied.
+     */
+    std::atomic<uint64_t> failed;
+    
+    /**
+     * The error code of the last failure, zero if none.
+     */
+    std::atomic<int> error;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    GammaMailbox(const GammaMailbox<T>&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    GammaMailbox<T>& operator =(const GammaMailbox<T>&) = delete;
+    
+    /**
+     * Put gamma ramps in the slot.
+     * 
+     * @param  ramps  The gamma ramps, the mailbox takes ownership of them.
+     */
+    void publish(GammaRamps<T>* ramps);
+    
+    /**
+     * The function that runs on the writer thread.
+     */
+    void run();
+    
+    
+    
+    /**
+     * The newest gamma ramps that have not been picked up
+     * by the writer yet, `nullptr` if there are none.
+     */
+    std::atomic<GammaRamps<T>*> slot;
+    
+    /**
+     * Whether the writer shall stop.
+     */
+    bool stopping;
+    
+    /**
+     * Used with `condition`, the slot itself is not guarded by it.
+     */
+    std::mutex mutex;
+    
+    /**
+     * Wakes the writer when gamma ramps are submitted,
+     * and `flush` when gamma ramps have been handled.
+     */
+    std::condition_variable condition;
+    
+    /**
+     * The writer thread.
+     */
+    std::thread writer;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,137 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-method-table.hh"
+
+#include "libgamma-facade.hh"
+
+
+namespace libgamma
+{
+  /**
+   * Constructor.
+   */
+  MethodInfo::MethodInfo() :
+    method(0),
+    available(false),
+    capabilities(),
+    has_default_site(false),
+    default_site(),
+    has_default_site_variable(false),
+    default_site_variable()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  MethodInfo::~MethodInfo()
+  {
+    /* Do nothing. */
+  }
+  
+  
+  /**
+   * Constructor, builds the table.
+   */
+  MethodTable::MethodTable() :
+    methods(),
+    lists()
+  {
+    libgamma_method_capabilities_t caps;
+    const char* cstr;
+    char* site;
+    int m, op;
+    
+    for (m = 0; m < LIBGAMMA_METHOD_COUNT; m++)
+      {
+	MethodInfo& info = this->methods[m];
+	info.method = m;
+	info.available = libgamma_is_method_available(m) != 0;
+	libgamma_method_capabilities(&caps, m);
+	info.capabilities = MethodCapabilities(&caps);
+	site = libgamma_method_default_site(m);
+	if (site != nullptr)
+	  {
+	    info.has_default_site = true;
+	    info.default_site = site;
+	  }
+	cstr = libgamma_method_default_site_variable(m);
+	if (cstr != nullptr)
+	  {
+	    info.has_default_site_variable = true;
+	    info.default_site_variable = cstr;
+	  }
+      }
+    
+    for (op = 0; op < 5; op++)
+      this->lists[op] = list_methods(op);
+  }
+  
+  /**
+   * Get the process-wide table, building it if it has not been built.
+   * 
+   * @return  The table.
+   */
+  const MethodTable& MethodTable::get()
+  {
+    /* Initialisation of local statics is thread-safe and happens once. */
+    static MethodTable* table = new MethodTable();
+    return *table;
+  }
+  
+  /**
+   * Get information about an adjustment method.
+   * 
+   * @param   method  The adjustment method, must be in [0, `LIBGAMMA_METHOD_COUNT`).
+   * @return          Information about the adjustment method.
+   */
+  const MethodInfo& MethodTable::method(int method) const
+  {
+    return this->methods[method];
+  }
+  
+  /**
+   * Check whether an adjustment method is available, non-existing
+   * (invalid) methods are identified as not available.
+   * 
+   * @param   method  The adjustment method.
+   * @return          Whether the adjustment method is available.
+   */
+  bool MethodTable::is_available(int method) const
+  {
+    if ((method < 0) || (method >= LIBGAMMA_METHOD_COUNT))
+      return false;
+    return this->methods[method].available;
+  }
+  
+  /**
+   * List available adjustment methods by their order of preference based on the environment.
+   * 
+   * @param   operation  See `list_methods`, values outside [0, 4] are treated as 4.
+   * @return             The methods.
+   */
+  const std::vector<int>& MethodTable::list(int operation) const
+  {
+    if ((operation < 0) || (operation > 4))
+      operation = 4;
+    return this->lists[operation];
+  }
+  
+}
+
@@ -0,0 +1,178 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_METHOD_TABLE_HH
+#define LIBGAMMA_METHOD_TABLE_HH
+
+
+#include <string>
+#include <vector>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * Information about an adjustment method.
+   */
+  class MethodInfo
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    MethodInfo();
+    
+    /**
+     * Destructor.
+     */
+    ~MethodInfo();
+    
+    
+    
+    /**
+     * The adjustment method.
+     */
+    int method;
+    
+    /**
+     * Whether the adjustment method is available.
+     */
+    bool available;
+    
+    /**
+     * The capabilities of the adjustment method.
+     */
+    MethodCapabilities capabilities;
+    
+    /**
+     * Whether the adjustment method has a default site.
+     */
+    bool has_default_site;
+    
+    /**
+     * The default site, empty if `has_default_site` is false.
+     */
+    std::string default_site;
+    
+    /**
+     * Whether the adjustment method has a default site variable.
+     */
+    bool has_default_site_variable;
+    
+    /**
+     * The environment variable that determines the default site,
+     * empty if `has_default_site_variable` is false.
+     */
+    std::string default_site_variable;
+    
+  };
+  
+  
+  /**
+   * A table of all adjustment methods, with their availability,
+   * capabilities and default sites, and the lists returned by
+   * `list_methods`.
+   * 
+   * The table is built once, the first time it is used, and is
+   * immutable afterwards, so lookups do not call libgamma, do not
+   * allocate and are thread-safe. Because of that, the entries that
+   * depend on the environment, such as the default sites and the
+   * methods the environment suggests, reflect the environment when
+   * the table was built.
+   */
+  class MethodTable
+  {
+  public:
+    /**
+     * Get the process-wide table, building it if it has not been built.
+     * 
+     * @return  The table.
+     */
+    static const MethodTable& get();
+    
+    /**
+     * Get information about an adjustment method.
+     * 
+     * @param   method  The adjustment method, must be in [0, `LIBGAMMA_METHOD_COUNT`).
+     * @return          Information about the adjustment method.
+     */
+    const MethodInfo& method(int method) const __attribute__((const));
+    
+    /**
+     * Check whether an adjustment method is available, non-existing
+     * (invalid) methods are identified as not available.
+     * 
+     * @param   method  The adjustment method.
+     * @return          Whether the adjustment method is available.
+     */
+    bool is_available(int method) const __attribute__((pure));
+    
+    /**
+     * List available adjustment methods by their order of preference based on the environment.
+     * 
+     * @param   operation  See `list_methods`, values outside [0, 4] are treated as 4.
+     * @return             The methods.
+     */
+    const std::vector<int>& list(int operation) const __attribute__((const));
+    
+    
+    
+    /**
+     * Information about each adjustment method, indexed by method.
+     */
+    MethodInfo methods[LIBGAMMA_METHOD_COUNT];
+    
+    /**
+     * The result of `list_methods` for each operation.
+     */
+    std::vector<int> lists[5];
+  
+  private:
+    /**
+     * Constructor, builds the table.
+     */
+    MethodTable();
+    
+    /**
+     * Copy constructor, deleted.
+     */
+    MethodTable(const MethodTable&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    MethodTable& operator =(const MethodTable&) = delete;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -19,9 +19,12 @@
 
 #include "libgamma-error.hh"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <new>
+#include <utility>
 
 
 namespace libgamma
@@ -143,6 +146,7 @@ namespace libgamma
   CRTCInformation::CRTCInformation() :
     edid(nullptr),
     edid_length(0),
+    edid_capacity(0),
     edid_error(0),
     width_mm(0),
     width_mm_error(0),
@@ -185,6 +189,7 @@ namespace libgamma
   CRTCInformation::CRTCInformation(libgamma_crtc_information_t* info) :
     edid(info->edid),
     edid_length(info->edid_length),
+    edid_capacity(info->edid == nullptr ? 0 : info->edid_length),
     edid_error(info->edid_error),
     width_mm(info->width_mm),
     width_mm_error(info->width_mm_error),
@@ -231,6 +236,7 @@ namespace libgamma
   CRTCInformation::CRTCInformation(const CRTCInformation& other) :
     edid(nullptr),
     edid_length(other.edid_length),
+    edid_capacity(0),
     edid_error(other.edid_error),
     width_mm(other.width_mm),
     width_mm_error(other.width_mm_error),
@@ -263,7 +269,11 @@ namespace libgamma
   {
     if (other.edid != nullptr)
       {
-	this->edid = (unsigned char*)malloc(this->edid_length * sizeof(unsigned char));
+	/* Allocate at least one byte so that an empty EDID is not `nullptr`. */
+	this->edid_capacity = this->edid_length == 0 ? 1 : this->edid_length;
+	this->edid = (unsigned char*)malloc(this->edid_capacity * sizeof(unsigned char));
+	if (this->edid == nullptr)
+	  __LIBGAMMA_THROW(ENOMEM);
 	memcpy(this->edid, other.edid, this->edid_length * sizeof(unsigned char));
       }
     if (other.connector_name != nullptr)
@@ -289,7 +299,30 @@ namespace libgamma
    */
   CRTCInformation& CRTCInformation::operator =(const CRTCInformation& other)
   {
-    this->edid = nullptr;
+    if (this == &other)
+      return *this;
+    
+    /* Reuse the EDID buffer if it is large enough. The buffer is replaced
+     * before anything is changed, so nothing is changed if it fails. */
+    if (other.edid == nullptr)
+      {
+	free(this->edid);
+	this->edid = nullptr;
+	this->edid_capacity = 0;
+      }
+    else if ((this->edid == nullptr) || (this->edid_capacity < other.edid_length))
+      {
+	size_t capacity = other.edid_length == 0 ? 1 : other.edid_length;
+	unsigned char* new_edid = (unsigned char*)malloc(capacity * sizeof(unsigned char));
+	if (new_edid == nullptr)
+	  __LIBGAMMA_THROW(ENOMEM);
+	free(this->edid);
+	this->edid = new_edid;
+	this->edid_capacity = capacity;
+      }
+    if (other.edid != nullptr)
+      memcpy(this->edid, other.edid, other.edid_length * sizeof(unsigned char));
+    
     this->edid_length = other.edid_length;
     this->edid_error = other.edid_error;
     this->width_mm = other.width_mm;
@@ -312,7 +345,6 @@ namespace libgamma
     this->subpixel_order_error = other.subpixel_order_error;
     this->active = other.active;
     this->active_error = other.active_error;
-    this->connector_name = nullptr;
     this->connector_name_error = other.connector_name_error;
     this->connector_type = other.connector_type;
     this->connector_type_error = other.connector_type_error;
@@ -321,17 +353,80 @@ namespace libgamma
     this->gamma_blue = other.gamma_blue;
     this->gamma_error = other.gamma_error;
     
-    if (other.edid != nullptr)
+    /* Reuse the connector name string. */
+    if (other.connector_name == nullptr)
       {
-	this->edid = (unsigned char*)malloc(this->edid_length * sizeof(unsigned char));
-	memcpy(this->edid, other.edid, this->edid_length * sizeof(unsigned char));
+	delete this->connector_name;
+	this->connector_name = nullptr;
       }
-    if (other.connector_name != nullptr)
+    else if (this->connector_name == nullptr)
       this->connector_name = new std::string(*(other.connector_name));
+    else
+      *(this->connector_name) = *(other.connector_name);
     
     return *this;
   }
   
+  
+  /**
+   * Replace the information with the information in a native
+   * structure. The EDID is taken over rather than copied, and
+   * the storage of the connector name is reused.
+   * 
+   * @param  info  The information in the native structure, its
+   *               `edid` is owned by this object afterwards and
+   *               its `connector_name` is freed.
+   */
+  void CRTCInformation::assign(libgamma_crtc_information_t* info)
+  {
+    free(this->edid);
+    this->edid = info->edid;
+    this->edid_length = info->edid_length;
+    this->edid_capacity = info->edid == nullptr ? 0 : info->edid_length;
+    this->edid_error = info->edid_error;
+    this->width_mm = info->width_mm;
+    this->width_mm_error = info->width_mm_error;
+    this->height_mm = info->height_mm;
+    this->height_mm_error = info->height_mm_error;
+    this->width_mm_edid = info->width_mm_edid;
+    this->width_mm_edid_error = info->width_mm_edid_error;
+    this->height_mm_edid = info->height_mm_edid;
+    this->height_mm_edid_error = info->height_mm_edid_error;
+    this->red_gamma_size = info->red_gamma_size;
+    this->green_gamma_size = info->green_gamma_size;
+    this->blue_gamma_size = info->blue_gamma_size;
+    this->gamma_size_error = info->gamma_size_error;
+    this->gamma_depth = info->gamma_depth;
+    this->gamma_depth_error = info->gamma_depth_error;
+    this->gamma_support = info->gamma_support;
+    this->gamma_support_error = info->gamma_support_error;
+    this->subpixel_order = info->subpixel_order;
+    this->subpixel_order_error = info->subpixel_order_error;
+    this->active = info->active;
+    this->active_error = info->active_error;
+    this->connector_name_error = info->connector_name_error;
+    this->connector_type = info->connector_type;
+    this->connector_type_error = info->connector_type_error;
+    this->gamma_red = info->gamma_red;
+    this->gamma_green = info->gamma_green;
+    this->gamma_blue = info->gamma_blue;
+    this->gamma_error = info->gamma_error;
+    
+    if (info->connector_name == nullptr)
+      {
+	delete this->connector_name;
+	this->connector_name = nullptr;
+      }
+    else
+      {
+	if (this->connector_name == nullptr)
+	  this->connector_name = new std::string(info->connector_name);
+	else
+	  this->connector_name->assign(info->connector_name);
+	free(info->connector_name);
+      }
+  }
+  
 #ifdef __GCC__
 # pragma GCC diagnostic push
 # pragma GCC diagnostic ignored "-Wshadow"
@@ -344,7 +439,9 @@ namespace libgamma
     method(0),
     site(nullptr),
     partitions_available(0),
-    native(nullptr)
+    native(nullptr),
+    mutex(),
+    open_partitions()
   {
     /* Do nothing. */
   }
@@ -360,28 +457,83 @@ namespace libgamma
     method(method),
     site(site),
     partitions_available(0),
-    native(nullptr)
+    native(nullptr),
+    mutex(),
+    open_partitions()
+  {
+    int r = this->initialise();
+    if (r != 0)
+      __LIBGAMMA_THROW(r);
+  }
+  
+  /**
+   * Create a site without throwing.
+   * 
+   * @param   method  The adjustment method of the site.
+   * @param   site    The site identifier, will be moved into the
+   *                  structure, must be `delete`:able, it is
+   *                  deleted if the site cannot be created.
+   * @return          The site, or the error code.
+   */
+  Result<Site*> Site::open(int method, std::string* site) noexcept
+  {
+    Site* rc = new (std::nothrow) Site();
+    int r;
+    if (rc == nullptr)
+      {
+	delete site;
+	return Result<Site*>(ENOMEM, nullptr);
+      }
+    rc->method = method;
+    rc->site = site;
+    r = rc->initialise();
+    if (r != 0)
+      {
+	delete rc;
+	return Result<Site*>(r, nullptr);
+      }
+    return Result<Site*>(0, rc);
+  }
+  
+  /**
+   * Initialise the native state, `method` and `site` must be set.
+   * 
+   * @return  Zero on success, otherwise the error code.
+   */
+  int Site::initialise() noexcept
   {
     char* cstr = nullptr;
     int r;
     
-    if (site != nullptr)
+    if (this->site != nullptr)
       {
-	const char* cstr_ = site->c_str();
+	const char* cstr_ = this->site->c_str();
 	cstr = (char*)malloc((strlen(cstr_) + 1) * sizeof(char));
+	if (cstr == nullptr)
+	  return ENOMEM;
 	memcpy(cstr, cstr_, (strlen(cstr_) + 1) * sizeof(char));
       }
     this->native = (libgamma_site_state_t*)malloc(sizeof(libgamma_site_state_t));
-    r = libgamma_site_initialise(this->native, method, cstr);
+    if (this->native == nullptr)
+      {
+	free(cstr);
+	return ENOMEM;
+      }
+    {
+      __LIBGAMMA_PROBE_BEGIN(STATS_SITE_INITIALISE, nullptr);
+      __LIBGAMMA_PROBE_DESCRIBE(this->method, (size_t)-1, (size_t)-1, 0, 0, 0, 0);
+      r = libgamma_site_initialise(this->native, this->method, cstr);
+      __LIBGAMMA_PROBE_END(r);
+    }
     if (r < 0)
       {
-	int saved_errno = errno;
+	r = resolve_error(r);
 	free(this->native);
 	this->native = nullptr;
-	errno = saved_errno;
-	throw create_error(r);
+	return r;
       }
     this->partitions_available = this->native->partitions_available;
+    return 0;
   }
   
   /**
@@ -401,10 +553,38 @@ namespace libgamma
    */
   void Site::restore()
   {
-    int r;
-    r = libgamma_site_restore(this->native);
+    int r = this->try_restore();
     if (r != 0)
-      throw create_error(r);
+      __LIBGAMMA_THROW(r);
+  }
+  
+  /**
+   * Restore the gamma ramps all CRTC:s with a site to
+   * the system settings, without throwing.
+   * 
+   * @return  Zero on success, otherwise the error code.
+   */
+  int Site::try_restore() noexcept
+  {
+    int r;
+    __LIBGAMMA_SERIALISE_SITE(this);
+#ifndef LIBGAMMAMM_NO_LOCKING
+    /* Partitions that are graphics cards have their own locks,
+     * they are taken in partition order to avoid deadlocks. */
+    for (Partition* partition : this->open_partitions)
+      partition->mutex.lock();
+#endif
+    {
+      __LIBGAMMA_PROBE_BEGIN(STATS_RESTORE, nullptr);
+      __LIBGAMMA_PROBE_DESCRIBE(this->method, (size_t)-1, (size_t)-1, 0, 0, 0, 0);
+      r = libgamma_site_restore(this->native);
+      __LIBGAMMA_PROBE_END(r);
+    }
+#ifndef LIBGAMMAMM_NO_LOCKING
+    for (Partition* partition : this->open_partitions)
+      partition->mutex.unlock();
+#endif
+    return r == 0 ? 0 : resolve_error(r);
   }
   
   
@@ -416,7 +596,9 @@ namespace libgamma
     site(nullptr),
     partition(0),
     crtcs_available(0),
-    native(nullptr)
+    native(nullptr),
+    mutex(),
+    serial(&(this->mutex))
   {
     /* Do nothing. */
   }
@@ -431,20 +613,94 @@ namespace libgamma
     site(site),
     partition(partition),
     crtcs_available(0),
-    native(nullptr)
+    native(nullptr),
+    mutex(),
+    serial(&(this->mutex))
+  {
+    int r = this->initialise();
+    if (r != 0)
+      __LIBGAMMA_THROW(r);
+  }
+  
+  /**
+   * Create a partition without throwing.
+   * 
+   * @param   site       The site of the partition.
+   * @param   partition  The index of the partition.
+   * @return             The partition, or the error code.
+   */
+  Result<Partition*> Partition::open(Site* site, size_t partition) noexcept
+  {
+    Partition* rc = new (std::nothrow) Partition();
+    int r;
+    if (rc == nullptr)
+      return Result<Partition*>(ENOMEM, nullptr);
+    rc->site = site;
+    rc->partition = partition;
+    r = rc->initialise();
+    if (r != 0)
+      {
+	delete rc;
+	return Result<Partition*>(r, nullptr);
+      }
+    return Result<Partition*>(0, rc);
+  }
+  
+  /**
+   * Initialise the native state, `site` and `partition` must be set.
+   * 
+   * @return  Zero on success, otherwise the error code.
+   */
+  int Partition::initialise() noexcept
   {
+    libgamma_method_capabilities_t caps;
     int r;
+    libgamma_method_capabilities(&caps, this->site->method);
+    this->serial = caps.partitions_are_graphics_cards ? &(this->mutex) : &(this->site->mutex);
     this->native = (libgamma_partition_state_t*)malloc(sizeof(libgamma_partition_state_t));
-    r = libgamma_partition_initialise(this->native, site->native, partition);
-    if (r < 0)
+    if (this->native == nullptr)
+      return ENOMEM;
+    {
+      std::lock_guard<std::mutex> lock(this->site->mutex);
+      {
+	__LIBGAMMA_PROBE_BEGIN(STATS_PARTITION_INITIALISE, nullptr);
+	__LIBGAMMA_PROBE_DESCRIBE(this->site->method, this->partition, (size_t)-1, 0, 0, 0, 0);
+	r = libgamma_partition_initialise(this->native, this->site->native, this->partition);
+	__LIBGAMMA_PROBE_END(r);
+      }
+      if ((r >= 0) && (this->serial == &(this->mutex)))
+	{
+	  /* Register the partition so that `Site::restore` can take its lock. */
+	  std::vector<Partition*>& list = this->site->open_partitions;
+	  auto it = std::upper_bound(list.begin(), list.end(), this,
+				     [](const Partition* a, const Partition* b)
+				     {
+				       return a->partition < b->partition;
+				     });
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+	  try
+#endif
+	    {
+	      list.insert(it, this);
+	    }
+#ifdef LIBGAMMA_HAVE_EXCEPTIONS
+	  catch (...)
+	    {
+	      libgamma_partition_destroy(this->native);
+	      r = ENOMEM;
+	    }
+#endif
+	}
+    }
+    if (r != 0)
       {
-	int saved_errno = errno;
+	r = resolve_error(r);
 	free(this->native);
 	this->native = nullptr;
-	errno = saved_errno;
-	throw create_error(r);
+	return r;
       }
     this->crtcs_available = this->native->crtcs_available;
+    return 0;
   }
   
   /**
@@ -453,7 +709,15 @@ namespace libgamma
   Partition::~Partition()
   {
     if (this->native != nullptr)
-      libgamma_partition_free(this->native);
+      {
+	if (this->serial == &(this->mutex))
+	  {
+	    std::lock_guard<std::mutex> lock(this->site->mutex);
+	    std::vector<Partition*>& list = this->site->open_partitions;
+	    list.erase(std::remove(list.begin(), list.end(), this), list.end());
+	  }
+	libgamma_partition_free(this->native);
+      }
   }
   
   /**
@@ -461,11 +725,27 @@ namespace libgamma
    * to the system settings.
    */
   void Partition::restore()
+  {
+    int r = this->try_restore();
+    if (r != 0)
+      __LIBGAMMA_THROW(r);
+  }
+  
+  /**
+   * Restore the gamma ramps all CRTC:s with a partition
+   * to the system settings, without throwing.
+   * 
+   * @return  Zero on success, otherwise the error code.
+   */
+  int Partition::try_restore() noexcept
   {
     int r;
+    __LIBGAMMA_SERIALISE(this);
+    __LIBGAMMA_PROBE_BEGIN(STATS_RESTORE, nullptr);
+    __LIBGAMMA_PROBE_DESCRIBE(this->site->method, this->partition, (size_t)-1, 0, 0, 0, 0);
     r = libgamma_partition_restore(this->native);
-    if (r != 0)
-      throw create_error(r);
+    __LIBGAMMA_PROBE_END(r);
+    return r == 0 ? 0 : resolve_error(r);
   }
   
   
@@ -476,7 +756,12 @@ namespace libgamma
   CRTC::CRTC() :
     partition(nullptr),
     crtc(0),
-    native(nullptr)
+    native(nullptr),
+    elision(nullptr),
+    stats(nullptr),
+    information_cache(nullptr),
+    information_cached(0),
+    information_scratch(nullptr)
   {
     /* Do nothing. */
   }
@@ -490,19 +775,79 @@ namespace libgamma
   CRTC::CRTC(Partition* partition, size_t crtc) :
     partition(partition),
     crtc(crtc),
-    native(nullptr)
+    native(nullptr),
+    elision(nullptr),
+    stats(nullptr),
+    information_cache(nullptr),
+    information_cached(0),
+    information_scratch(nullptr)
+  {
+    int r = this->initialise();
+    if (r != 0)
+      __LIBGAMMA_THROW(r);
+  }
+  
+  /**
+   * Create a CRTC without throwing.
+   * 
+   * @param   partition  The partition of the CRTC.
+   * @param   crtc       The index of the CRTC.
+   * @return             The CRTC, or the error code.
+   */
+  Result<CRTC*> CRTC::open(Partition* partition, size_t crtc) noexcept
+  {
+    CRTC* rc = new (std::nothrow) CRTC();
+    int r;
+    if (rc == nullptr)
+      return Result<CRTC*>(ENOMEM, nullptr);
+    rc->partition = partition;
+    rc->crtc = crtc;
+    r = rc->initialise();
+    if (r != 0)
+      {
+	delete rc;
+	return Result<CRTC*>(r, nullptr);
+      }
+    return Result<CRTC*>(0, rc);
+  }
+  
+  /**
+   * Initialise the native state, `partition` and `crtc` must be set.
+   * 
+   * @return  Zero on success, otherwise the error code.
+   */
+  int CRTC::initialise() noexcept
   {
     int r;
+#ifndef LIBGAMMAMM_NO_STATS
+    this->stats = new (std::nothrow) StatsCounters();
+    if (this->stats == nullptr)
+      return ENOMEM;
+#endif
     this->native = (libgamma_crtc_state_t*)malloc(sizeof(libgamma_crtc_state_t));
-    r = libgamma_crtc_initialise(this->native, partition->native, crtc);
+    if (this->native == nullptr)
+      {
+	delete this->stats;
+	this->stats = nullptr;
+	return ENOMEM;
+      }
+    {
+      __LIBGAMMA_SERIALISE(this->partition);
+      __LIBGAMMA_PROBE_BEGIN(STATS_CRTC_INITIALISE, this->stats);
+      __LIBGAMMA_PROBE_DESCRIBE(this->partition->site->method, this->partition->partition, this->crtc, 0, 0, 0, 0);
+      r = libgamma_crtc_initialise(this->native, this->partition->native, this->crtc);
+      __LIBGAMMA_PROBE_END(r);
+    }
     if (r < 0)
       {
-	int saved_errno = errno;
+	r = resolve_error(r);
 	free(this->native);
 	this->native = nullptr;
-	errno = saved_errno;
-	throw create_error(r);
+	delete this->stats;
+	this->stats = nullptr;
+	return r;
       }
+    return 0;
   }
   
   /**
@@ -512,6 +857,10 @@ namespace libgamma
   {
     if (this->native != nullptr)
       libgamma_crtc_free(this->native);
+    delete this->elision;
+    delete this->stats;
+    delete this->information_cache;
+    delete this->information_scratch;
   }
   
   /**
@@ -519,30 +868,283 @@ namespace libgamma
    * settings for that CRTC.
    */
   void CRTC::restore()
+  {
+    int r = this->try_restore();
+    if (r != 0)
+      __LIBGAMMA_THROW(r);
+  }
+  
+  /**
+   * Restore the gamma ramps for a CRTC to the system
+   * settings for that CRTC, without throwing.
+   * 
+   * @return  Zero on success, otherwise the error code.
+   */
+  int CRTC::try_restore() noexcept
   {
     int r;
+    __LIBGAMMA_SERIALISE(this->partition);
+    if (this->elision != nullptr)
+      this->elision->invalidate();
+    __LIBGAMMA_PROBE_BEGIN(STATS_RESTORE, this->stats);
+    __LIBGAMMA_PROBE_DESCRIBE(this->partition->site->method, this->partition->partition, this->crtc, 0, 0, 0, 0);
     r = libgamma_crtc_restore(this->native);
-    if (r != 0)
-      throw create_error(r);
+    __LIBGAMMA_PROBE_END(r);
+    return r == 0 ? 0 : resolve_error(r);
   }
   
   /**
-   * Read information about a CRTC.
+   * Read information about a CRTC, the caller
+   * must hold the CRTC's partition's lock.
    * 
+   * @param   crtc    The CRTC.
    * @param   output  Instance of a data structure to fill with the information about the CRTC.
    * @param   fields  OR:ed identifiers for the information about the CRTC that should be read.
    * @return          Whether an error has occurred and is stored in a `*_error` field.
    */
-  bool CRTC::information(CRTCInformation* output, int32_t fields)
+  static bool read_information(CRTC* crtc, CRTCInformation* output, int32_t fields)
   {
     libgamma_crtc_information_t info;
     int r;
     
-    r = libgamma_get_crtc_information(&info, this->native, fields);
-    *output = CRTCInformation(&info);
+    /* Fields that are not requested are left untouched by libgamma. */
+    memset(&info, 0, sizeof(info));
+    {
+      __LIBGAMMA_PROBE_BEGIN(STATS_INFORMATION, crtc->stats);
+      __LIBGAMMA_PROBE_DESCRIBE(crtc->partition->site->method, crtc->partition->partition, crtc->crtc, 0, 0, 0, 0);
+      r = libgamma_get_crtc_information(&info, crtc->native, fields);
+      __LIBGAMMA_PROBE_END(r);
+    }
+    output->assign(&info);
     return r != 0;
   }
   
+  /**
+   * Read information about a CRTC.
+   * 
+   * @param   output  Instance of a data structure to fill with the information about the CRTC.
+   * @param   fields  OR:ed identifiers for the information about the CRTC that should be read.
+   * @return          Whether an error has occurred and is stored in a `*_error` field.
+   */
+  bool CRTC::information(CRTCInformation* output, int32_t fields)
+  {
+    __LIBGAMMA_SERIALISE(this->partition);
+    return read_information(this, output, fields);
+  }
+  
+  /**
+   * Move fields from one CRTC information object to another.
+   * The EDID and connector name are swapped rather than copied.
+   * 
+   * @param  dest    The information to update.
+   * @param  src     The information to take the fields from.
+   * @param  fields  OR:ed identifiers for the fields to move.
+   */
+  static void move_information_fields(CRTCInformation* dest, CRTCInformation* src, int32_t fields)
+  {
+    if (fields & LIBGAMMA_CRTC_INFO_EDID)
+      {
+	std::swap(dest->edid, src->edid);
+	std::swap(dest->edid_length, src->edid_length);
+	std::swap(dest->edid_capacity, src->edid_capacity);
+	dest->edid_error = src->edid_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_WIDTH_MM)
+      {
+	dest->width_mm = src->width_mm;
+	dest->width_mm_error = src->width_mm_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_HEIGHT_MM)
+      {
+	dest->height_mm = src->height_mm;
+	dest->height_mm_error = src->height_mm_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_WIDTH_MM_EDID)
+      {
+	dest->width_mm_edid = src->width_mm_edid;
+	dest->width_mm_edid_error = src->width_mm_edid_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_HEIGHT_MM_EDID)
+      {
+	dest->height_mm_edid = src->height_mm_edid;
+	dest->height_mm_edid_error = src->height_mm_edid_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_GAMMA_SIZE)
+      {
+	dest->red_gamma_size = src->red_gamma_size;
+	dest->green_gamma_size = src->green_gamma_size;
+	dest->blue_gamma_size = src->blue_gamma_size;
+	dest->gamma_size_error = src->gamma_size_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_GAMMA_DEPTH)
+      {
+	dest->gamma_depth = src->gamma_depth;
+	dest->gamma_depth_error = src->gamma_depth_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_GAMMA_SUPPORT)
+      {
+	dest->gamma_support = src->gamma_support;
+	dest->gamma_support_error = src->gamma_support_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_SUBPIXEL_ORDER)
+      {
+	dest->subpixel_order = src->subpixel_order;
+	dest->subpixel_order_error = src->subpixel_order_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_ACTIVE)
+      {
+	dest->active = src->active;
+	dest->active_error = src->active_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_CONNECTOR_NAME)
+      {
+	std::swap(dest->connector_name, src->connector_name);
+	dest->connector_name_error = src->connector_name_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_CONNECTOR_TYPE)
+      {
+	dest->connector_type = src->connector_type;
+	dest->connector_type_error = src->connector_type_error;
+      }
+    if (fields & LIBGAMMA_CRTC_INFO_GAMMA)
+      {
+	dest->gamma_red = src->gamma_red;
+	dest->gamma_green = src->gamma_green;
+	dest->gamma_blue = src->gamma_blue;
+	dest->gamma_error = src->gamma_error;
+      }
+  }
+  
+  /**
+   * Get the fields of CRTC information that could not be read.
+   * 
+   * @param   info    The information.
+   * @param   fields  OR:ed identifiers for the fields to check.
+   * @return          OR:ed identifiers for the fields, among `fields`,
+   *                  that have a nonzero `*_error` field.
+   */
+  static int32_t information_errors(const CRTCInformation* info, int32_t fields)
+  {
+    int32_t errors = 0;
+#define __LIBGAMMA_INFO_ERROR(FIELD, ERROR)		\
+    if (info->ERROR != 0)				\
+      errors |= LIBGAMMA_CRTC_INFO_ ## FIELD
+    __LIBGAMMA_INFO_ERROR(EDID, edid_error);
+    __LIBGAMMA_INFO_ERROR(WIDTH_MM, width_mm_error);
+    __LIBGAMMA_INFO_ERROR(HEIGHT_MM, height_mm_error);
+    __LIBGAMMA_INFO_ERROR(WIDTH_MM_EDID, width_mm_edid_error);
+    __LIBGAMMA_INFO_ERROR(HEIGHT_MM_EDID, height_mm_edid_error);
+    __LIBGAMMA_INFO_ERROR(GAMMA_SIZE, gamma_size_error);
+    __LIBGAMMA_INFO_ERROR(GAMMA_DEPTH, gamma_depth_error);
+    __LIBGAMMA_INFO_ERROR(GAMMA_SUPPORT, gamma_support_error);
+    __LIBGAMMA_INFO_ERROR(SUBPIXEL_ORDER, subpixel_order_error);
+    __LIBGAMMA_INFO_ERROR(ACTIVE, active_error);
+    __LIBGAMMA_INFO_ERROR(CONNECTOR_NAME, connector_name_error);
+    __LIBGAMMA_INFO_ERROR(CONNECTOR_TYPE, connector_type_error);
+    __LIBGAMMA_INFO_ERROR(GAMMA, gamma_error);
+#undef __LIBGAMMA_INFO_ERROR
+    return errors & fields;
+  }
+  
+  /**
+   * Read information about a CRTC, using cached values for fields
+   * that are not in `LIBGAMMA_INFO_DYNAMIC_FIELDS`. Such fields are
+   * read once, and again only after `invalidate_information` has
+   * been called, whereas dynamic fields are read on every call. The
+   * adjustment method is not called at all if only cached fields are
+   * requested. Fields that could not be read are not cached.
+   * 
+   * @param   output  Instance of a data structure to fill with the information about
+   *                  the CRTC, fields that are not requested are left unspecified.
+   * @param   fields  OR:ed identifiers for the information about the CRTC that should be read.
+   * @return          Whether an error has occurred and is stored in a `*_error` field.
+   */
+  bool CRTC::cached_information(CRTCInformation* output, int32_t fields)
+  {
+    __LIBGAMMA_SERIALISE(this->partition);
+    int32_t query = fields & ~(this->information_cached & ~LIBGAMMA_INFO_DYNAMIC_FIELDS);
+    
+    if (this->information_cache == nullptr)
+      this->information_cache = new CRTCInformation();
+    
+    if (query != 0)
+      {
+	if (this->information_scratch == nullptr)
+	  this->information_scratch = new CRTCInformation();
+	read_information(this, this->information_scratch, query);
+	move_information_fields(this->information_cache, this->information_scratch, query);
+	this->information_cached |= query & ~LIBGAMMA_INFO_DYNAMIC_FIELDS
+	  & ~information_errors(this->information_cache, query);
+      }
+    
+    *output = *(this->information_cache);
+    return information_errors(output, fields) != 0;
+  }
+  
+  /**
+   * Forget the information cached by `cached_information`,
+   * this should be done when the monitor connected to the
+   * CRTC may have changed.
+   */
+  void CRTC::invalidate_information()
+  {
+    __LIBGAMMA_SERIALISE(this->partition);
+    this->information_cached = 0;
+  }
+  
+  /**
+   * Enable or disable skipping of `set_gamma` calls whose gamma
+   * ramps are identical to the last gamma ramps that were set.
+   * This is disabled by default. If the gamma ramps are changed
+   * by anything else than `set_gamma` and `restore` on this
+   * object, for example by `Site::restore`, `Partition::restore`
+   * or another process, `elision->invalidate()` must be called.
+   * 
+   * @param  enabled          Whether unchanged gamma ramps shall be skipped.
+   * @param  verify_contents  Whether the full gamma ramps, rather than
+   *                          just their hashes, shall be compared.
+   */
+  void CRTC::elide_unchanged(bool enabled, bool verify_contents)
+  {
+    __LIBGAMMA_SERIALISE(this->partition);
+    if (!enabled)
+      {
+	delete this->elision;
+	this->elision = nullptr;
+      }
+    else if (this->elision == nullptr)
+      this->elision = new GammaElision(verify_contents);
+    else
+      {
+	this->elision->verify = verify_contents;
+	this->elision->invalidate();
+      }
+  }
+  
+  /**
+   * Take a snapshot of the statistics for the native calls
+   * made for this CRTC, including its construction.
+   * 
+   * @param  output  Output parameter for the snapshot, all zeroes
+   *                 if the library was built without statistics.
+   */
+  void CRTC::statistics(Stats* output) const
+  {
+    if (this->stats != nullptr)
+      this->stats->snapshot(output);
+    else
+      memset(output, 0, sizeof(*output));
+  }
+  
+  /**
+   * Reset the statistics for this CRTC.
+   */
+  void CRTC::reset_statistics()
+  {
+    if (this->stats != nullptr)
+      this->stats->reset();
+  }
+  
 #ifdef __GCC__
 # pragma GCC diagnostic pop
 #endif
@@ -21,9 +21,15 @@
 
 #include <string>
 #include <cstdlib>
+#include <mutex>
+#include <vector>
 
 #include "libgamma-native.hh"
 #include "libgamma-error.hh"
+#include "libgamma-arena.hh"
+#include "libgamma-elision.hh"
+#include "libgamma-stats.hh"
+#include "libgamma-trace.hh"
 
 
 #ifndef __GCC__
@@ -32,6 +38,32 @@
 
 
 
+/**
+ * The CRTC information fields that can change whilst the same
+ * monitor stays connected, these are never cached by
+ * `CRTC::cached_information`. All other fields are cached.
+ */
+#define LIBGAMMA_INFO_DYNAMIC_FIELDS  (LIBGAMMA_CRTC_INFO_ACTIVE | LIBGAMMA_CRTC_INFO_GAMMA)
+
+
+/**
+ * Hold the lock that serialises calls on a partition, see
+ * `Partition::serial`, until the end of the scope. Define
+ * `LIBGAMMAMM_NO_LOCKING` to compile out the locking if
+ * the objects are only used by one thread.
+ */
+#ifndef LIBGAMMAMM_NO_LOCKING
+# define __LIBGAMMA_SERIALISE(PARTITION)				\
+  std::lock_guard<std::mutex> serialise_(*((PARTITION)->serial))
+# define __LIBGAMMA_SERIALISE_SITE(SITE)			\
+  std::lock_guard<std::mutex> serialise_((SITE)->mutex)
+#else
+# define __LIBGAMMA_SERIALISE(PARTITION)  /* Do nothing. */
+# define __LIBGAMMA_SERIALISE_SITE(SITE)  /* Do nothing. */
+#endif
+
+
+
 namespace libgamma
 {
   /**
@@ -252,6 +284,17 @@ namespace libgamma
      */
     CRTCInformation& operator =(const CRTCInformation& other);
     
+    /**
+     * Replace the information with the information in a native
+     * structure. The EDID is taken over rather than copied, and
+     * the storage of the connector name is reused.
+     * 
+     * @param  info  The information in the native structure, its
+     *               `edid` is owned by this object afterwards and
+     *               its `connector_name` is freed.
+     */
+    void assign(libgamma_crtc_information_t* info);
+    
     
     
     /**
@@ -267,6 +310,14 @@ namespace libgamma
      */
     size_t edid_length;
     
+    /**
+     * The number of bytes allocated for `edid`, at least
+     * `edid_length`. The copy operator reuses the buffer
+     * if it is large enough. It must be updated if `edid`
+     * is replaced by anything else than this class.
+     */
+    size_t edid_capacity;
+    
     /**
      * Zero on success, positive it holds the value `errno` had
      * when the reading failed, otherwise (negative) the value
@@ -575,8 +626,60 @@ namespace libgamma
   };
   
   
+  /**
+   * The bit-depth of gamma ramps with a specific element
+   * type, as used in `GammaRamps::depth`.
+   */
+  template <typename T>
+  class RampDepth;
+  
+#define __LIBGAMMA_RAMP_DEPTH(T, DEPTH)		\
+  template <>					\
+  class RampDepth<T>				\
+  {						\
+  public:					\
+    static const signed value = DEPTH;		\
+  }
+  
+  __LIBGAMMA_RAMP_DEPTH(uint8_t, 8);
+  __LIBGAMMA_RAMP_DEPTH(uint16_t, 16);
+  __LIBGAMMA_RAMP_DEPTH(uint32_t, 32);
+  __LIBGAMMA_RAMP_DEPTH(uint64_t, 64);
+  __LIBGAMMA_RAMP_DEPTH(float, -1);
+  __LIBGAMMA_RAMP_DEPTH(double, -2);
+  
+#undef __LIBGAMMA_RAMP_DEPTH
+  
+  
+  /**
+   * How the memory of a `GammaRamps` is owned.
+   */
+  enum RampOwnership
+    {
+      /**
+       * The ramps own one block allocated with `malloc`,
+       * starting at the red ramp, and free it when destroyed.
+       */
+      RAMP_OWNERSHIP_MALLOC,
+      
+      /**
+       * The ramps own one block allocated from `GammaRamps::arena`
+       * and return it to the arena when destroyed.
+       */
+      RAMP_OWNERSHIP_ARENA,
+      
+      /**
+       * The ramps are a view of memory owned by someone
+       * else, and nothing is freed when they are destroyed.
+       */
+      RAMP_OWNERSHIP_VIEW
+    };
+  
+  
   /**
    * Gamma ramp structure.
+   * 
+   * Gamma ramps can be moved but not copied.
    */
   template <typename T>
   class GammaRamps
@@ -589,7 +692,9 @@ namespace libgamma
       red(Ramp<T>(nullptr, 0)),
       green(Ramp<T>(nullptr, 0)),
       blue(Ramp<T>(nullptr, 0)),
-      depth(0)
+      depth(0),
+      ownership(RAMP_OWNERSHIP_MALLOC),
+      arena(nullptr)
     {
       /* Do nothing. */
     }
@@ -605,23 +710,104 @@ namespace libgamma
      * @param  blue_size    The size of the gamma ramp for the blue channel.
      * @param  gamma_depth  The bit-depth of the gamma ramps, -1 for single precision
      *                      floating point, and -2 for double precision floating point.
+     * @param  owner        `RAMP_OWNERSHIP_MALLOC` if the ramps are one block allocated
+     *                      with `malloc` that shall be freed with the ramps, or
+     *                      `RAMP_OWNERSHIP_VIEW` if they are owned by the caller.
      */
     GammaRamps(T* red_ramp, T* green_ramp, T* blue_ramp,
-	       size_t red_size, size_t green_size, size_t blue_size, signed gamma_depth) :
+	       size_t red_size, size_t green_size, size_t blue_size, signed gamma_depth,
+	       RampOwnership owner = RAMP_OWNERSHIP_MALLOC) :
       red(Ramp<T>(red_ramp, red_size)),
       green(Ramp<T>(green_ramp, green_size)),
       blue(Ramp<T>(blue_ramp, blue_size)),
-      depth(gamma_depth)
+      depth(gamma_depth),
+      ownership(owner),
+      arena(nullptr)
     {
       /* Do nothing. */
     }
     
+    /**
+     * Move constructor.
+     * 
+     * @param  other  The gamma ramps to take over, they
+     *                will be left as empty views.
+     */
+    GammaRamps(GammaRamps<T>&& other) :
+      red(other.red),
+      green(other.green),
+      blue(other.blue),
+      depth(other.depth),
+      ownership(other.ownership),
+      arena(other.arena)
+    {
+      other.forget();
+    }
+    
     /**
      * Destructor.
      */
     ~GammaRamps()
     {
-      free(this->red.ramp);
+      this->release();
+    }
+    
+    /**
+     * Move operator.
+     * 
+     * @param   other  The gamma ramps to take over, they
+     *                 will be left as empty views.
+     * @return         This object.
+     */
+    GammaRamps<T>& operator =(GammaRamps<T>&& other)
+    {
+      if (this != &other)
+	{
+	  this->release();
+	  this->red = other.red;
+	  this->green = other.green;
+	  this->blue = other.blue;
+	  this->depth = other.depth;
+	  this->ownership = other.ownership;
+	  this->arena = other.arena;
+	  other.forget();
+	}
+      return *this;
+    }
+    
+    /**
+     * Create gamma ramps that use memory owned by the caller,
+     * for example a stack buffer or mapped memory. Nothing is
+     * freed when the gamma ramps are destroyed, so the memory
+     * must outlive them.
+     * 
+     * @param   red_ramp    The red gamma ramp.
+     * @param   green_ramp  The green gamma ramp.
+     * @param   blue_ramp   The blue gamma ramp.
+     * @param   red_size    The size of the gamma ramp for the red channel.
+     * @param   green_size  The size of the gamma ramp for the green channel.
+     * @param   blue_size   The size of the gamma ramp for the blue channel.
+     * @return              The gamma ramps.
+     */
+    static GammaRamps<T> view(T* red_ramp, T* green_ramp, T* blue_ramp,
+			      size_t red_size, size_t green_size, size_t blue_size)
+    {
+      return GammaRamps<T>(red_ramp, green_ramp, blue_ramp, red_size, green_size, blue_size,
+			   RampDepth<T>::value, RAMP_OWNERSHIP_VIEW);
+    }
+    
+    /**
+     * Get the size of the memory block the ramps use when
+     * they are allocated from a `RampArena`, where each
+     * channel starts on its own cache line.
+     * 
+     * @return  The size of the block, in bytes.
+     */
+    size_t block_size() const
+    {
+      return RampArena::padded(this->red.size * sizeof(T))
+	+ RampArena::padded(this->green.size * sizeof(T))
+	+ RampArena::padded(this->blue.size * sizeof(T));
     }
     
     
@@ -647,6 +833,49 @@ namespace libgamma
      */
     signed depth;
     
+    /**
+     * How the memory of the ramps is owned.
+     */
+    RampOwnership ownership;
+    
+    /**
+     * The arena the ramps were allocated from if
+     * `ownership` is `RAMP_OWNERSHIP_ARENA`.
+     */
+    RampArena* arena;
+    
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    GammaRamps(const GammaRamps<T>&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    GammaRamps<T>& operator =(const GammaRamps<T>&) = delete;
+    
+    /**
+     * Free the memory of the ramps if it is owned.
+     */
+    void release()
+    {
+      if (this->ownership == RAMP_OWNERSHIP_MALLOC)
+	free(this->red.ramp);
+      else if (this->ownership == RAMP_OWNERSHIP_ARENA)
+	this->arena->release(this->red.ramp, this->block_size());
+    }
+    
+    /**
+     * Turn the ramps into an empty view, without freeing anything.
+     */
+    void forget()
+    {
+      this->red = this->green = this->blue = Ramp<T>(nullptr, 0);
+      this->ownership = RAMP_OWNERSHIP_VIEW;
+      this->arena = nullptr;
+    }
+    
   };
   
   
@@ -659,6 +888,14 @@ namespace libgamma
    * pluggable graphics, like Unix-like systems such as GNU/Linux
    * and the BSD:s, there can usually be any (feasible) number of
    * sites. In X.org parlance they are called displays.
+   * 
+   * Sites, partitions and CRTC:s may be used from multiple
+   * threads. Calls that use the same connection to the display
+   * server or graphics card are serialised: calls on CRTC:s on
+   * different partitions run in parallel if the adjustment
+   * method's partitions are graphics cards, and otherwise
+   * calls on the same site are serialised. Objects must not
+   * be destroyed whilst they, or their children, are in use.
    */
   class Site
   {
@@ -677,6 +914,17 @@ namespace libgamma
      */
     Site(int method, std::string* site = nullptr);
     
+    /**
+     * Create a site without throwing.
+     * 
+     * @param   method  The adjustment method of the site.
+     * @param   site    The site identifier, will be moved into the
+     *                  structure, must be `delete`:able, it is
+     *                  deleted if the site cannot be created.
+     * @return          The site, or the error code.
+     */
+    static Result<Site*> open(int method, std::string* site = nullptr) noexcept;
+    
     /**
      * Destructor.
      */
@@ -688,6 +936,14 @@ namespace libgamma
      */
     void restore();
     
+    /**
+     * Restore the gamma ramps all CRTC:s with a site to
+     * the system settings, without throwing.
+     * 
+     * @return  Zero on success, otherwise the error code.
+     */
+    int try_restore() noexcept;
+    
     
     
     /**
@@ -724,6 +980,28 @@ namespace libgamma
      */
     libgamma_site_state_t* native;
     
+    /**
+     * Serialises calls on the site, and on its partitions and
+     * CRTC:s unless the partitions are graphics cards.
+     */
+    std::mutex mutex;
+    
+    /**
+     * The open partitions that have their own lock, because
+     * they are graphics cards, sorted by index. `restore` takes
+     * their locks, in this order, after `mutex`. It is guarded
+     * by `mutex` and maintained by `Partition`.
+     */
+    std::vector<Partition*> open_partitions;
+    
+  private:
+    /**
+     * Initialise the native state, `method` and `site` must be set.
+     * 
+     * @return  Zero on success, otherwise the error code.
+     */
+    int initialise() noexcept;
+    
   };
   
   
@@ -739,6 +1017,8 @@ namespace libgamma
    * and the mapping from monitors to screens is a surjection.
    * On hardware-level adjustment methods, such as Direct
    * Rendering Manager, a partition is a graphics card.
+   * 
+   * See `Site` for the thread-safety of partitions.
    */
   class Partition
   {
@@ -756,6 +1036,15 @@ namespace libgamma
      */
     Partition(Site* site, size_t partition);
     
+    /**
+     * Create a partition without throwing.
+     * 
+     * @param   site       The site of the partition.
+     * @param   partition  The index of the partition.
+     * @return             The partition, or the error code.
+     */
+    static Result<Partition*> open(Site* site, size_t partition) noexcept;
+    
     /**
      * Destructor.
      */
@@ -767,6 +1056,14 @@ namespace libgamma
      */
     void restore();
     
+    /**
+     * Restore the gamma ramps all CRTC:s with a partition
+     * to the system settings, without throwing.
+     * 
+     * @return  Zero on success, otherwise the error code.
+     */
+    int try_restore() noexcept;
+    
     
     
     /**
@@ -791,6 +1088,29 @@ namespace libgamma
      */
     libgamma_partition_state_t* native;
     
+    /**
+     * Serialises calls on the partition and its CRTC:s
+     * if the adjustment method's partitions are graphics
+     * cards, and thus have their own connections.
+     */
+    std::mutex mutex;
+    
+    /**
+     * The lock that calls on the partition and its CRTC:s
+     * hold: `mutex` if the adjustment method's partitions
+     * are graphics cards, and otherwise the site's `mutex`,
+     * as the partitions share the site's connection.
+     */
+    std::mutex* serial;
+    
+  private:
+    /**
+     * Initialise the native state, `site` and `partition` must be set.
+     * 
+     * @return  Zero on success, otherwise the error code.
+     */
+    int initialise() noexcept;
+    
   };
   
   
@@ -801,6 +1121,10 @@ namespace libgamma
    * The CRTC controls the gamma ramps for the
    * monitor that is plugged in to the connector
    * that the CRTC belongs to.
+   * 
+   * See `Site` for the thread-safety of CRTC:s. The
+   * fields should not be modified whilst the CRTC
+   * is used by another thread.
    */
   class CRTC
   {
@@ -818,6 +1142,15 @@ namespace libgamma
      */
     CRTC(Partition* partition, size_t crtc);
     
+    /**
+     * Create a CRTC without throwing.
+     * 
+     * @param   partition  The partition of the CRTC.
+     * @param   crtc       The index of the CRTC.
+     * @return             The CRTC, or the error code.
+     */
+    static Result<CRTC*> open(Partition* partition, size_t crtc) noexcept;
+    
     /**
      * Destructor.
      */
@@ -829,6 +1162,14 @@ namespace libgamma
      */
     void restore();
     
+    /**
+     * Restore the gamma ramps for a CRTC to the system
+     * settings for that CRTC, without throwing.
+     * 
+     * @return  Zero on success, otherwise the error code.
+     */
+    int try_restore() noexcept;
+    
     /**
      * Read information about a CRTC.
      * 
@@ -838,6 +1179,56 @@ namespace libgamma
      */
     bool information(CRTCInformation* output, int32_t fields);
     
+    /**
+     * Read information about a CRTC, using cached values for fields
+     * that are not in `LIBGAMMA_INFO_DYNAMIC_FIELDS`. Such fields are
+     * read once, and again only after `invalidate_information` has
+     * been called, whereas dynamic fields are read on every call. The
+     * adjustment method is not called at all if only cached fields are
+     * requested. Fields that could not be read are not cached.
+     * 
+     * @param   output  Instance of a data structure to fill with the information about
+     *                  the CRTC, fields that are not requested are left unspecified.
+     * @param   fields  OR:ed identifiers for the information about the CRTC that should be read.
+     * @return          Whether an error has occurred and is stored in a `*_error` field.
+     */
+    bool cached_information(CRTCInformation* output, int32_t fields);
+    
+    /**
+     * Forget the information cached by `cached_information`,
+     * this should be done when the monitor connected to the
+     * CRTC may have changed.
+     */
+    void invalidate_information();
+    
+    /**
+     * Enable or disable skipping of `set_gamma` calls whose gamma
+     * ramps are identical to the last gamma ramps that were set.
+     * This is disabled by default. If the gamma ramps are changed
+     * by anything else than `set_gamma` and `restore` on this
+     * object, for example by `Site::restore`, `Partition::restore`
+     * or another process, `elision->invalidate()` must be called.
+     * 
+     * @param  enabled          Whether unchanged gamma ramps shall be skipped.
+     * @param  verify_contents  Whether the full gamma ramps, rather than
+     *                          just their hashes, shall be compared.
+     */
+    void elide_unchanged(bool enabled, bool verify_contents = false);
+    
+    /**
+     * Take a snapshot of the statistics for the native calls
+     * made for this CRTC, including its construction.
+     * 
+     * @param  output  Output parameter for the snapshot, all zeroes
+     *                 if the library was built without statistics.
+     */
+    void statistics(Stats* output) const;
+    
+    /**
+     * Reset the statistics for this CRTC.
+     */
+    void reset_statistics();
+    
 #define __LIBGAMMA_GET_GAMMA(AFFIX)						\
     libgamma_gamma_ramps ## AFFIX ## _t ramps_;					\
     int r;									\
@@ -847,66 +1238,78 @@ namespace libgamma
     ramps_.red_size = ramps->red.size;						\
     ramps_.green_size = ramps->green.size;					\
     ramps_.blue_size = ramps->blue.size;					\
+    __LIBGAMMA_SERIALISE(this->partition);					\
+    __LIBGAMMA_PROBE_BEGIN(STATS_GET_GAMMA, this->stats);			\
+    __LIBGAMMA_PROBE_DESCRIBE(this->partition->site->method,			\
+			      this->partition->partition, this->crtc,		\
+			      ramps_.red_size, ramps_.green_size,		\
+			      ramps_.blue_size, ramps->depth);			\
     r = libgamma_crtc_get_gamma_ramps ## AFFIX(this->native, &ramps_);		\
-    if (r != 0)									\
-      throw create_error(r)
+    __LIBGAMMA_PROBE_END(r);							\
+    return r == 0 ? 0 : resolve_error(r)
     
     /**
-     * Get the current gamma ramps for the CRTC.
+     * Get the current gamma ramps for the CRTC, without throwing.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param   ramps  The gamma ramps to fill with the current values.
+     * @return         Zero on success, otherwise the error code.
      */
-    void get_gamma(GammaRamps<uint8_t>* ramps)
+    int try_get_gamma(GammaRamps<uint8_t>* ramps) noexcept
     {
       __LIBGAMMA_GET_GAMMA(8);
     }
     
     /**
-     * Get the current gamma ramps for the CRTC.
+     * Get the current gamma ramps for the CRTC, without throwing.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param   ramps  The gamma ramps to fill with the current values.
+     * @return         Zero on success, otherwise the error code.
      */
-    void get_gamma(GammaRamps<uint16_t>* ramps)
+    int try_get_gamma(GammaRamps<uint16_t>* ramps) noexcept
     {
       __LIBGAMMA_GET_GAMMA(16);
     }
     
     /**
-     * Get the current gamma ramps for the CRTC.
+     * Get the current gamma ramps for the CRTC, without throwing.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param   ramps  The gamma ramps to fill with the current values.
+     * @return         Zero on success, otherwise the error code.
      */
-    void get_gamma(GammaRamps<uint32_t>* ramps)
+    int try_get_gamma(GammaRamps<uint32_t>* ramps) noexcept
     {
       __LIBGAMMA_GET_GAMMA(32);
     }
     
     /**
-     * Get the current gamma ramps for the CRTC.
+     * Get the current gamma ramps for the CRTC, without throwing.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param   ramps  The gamma ramps to fill with the current values.
+     * @return         Zero on success, otherwise the error code.
      */
-    void get_gamma(GammaRamps<uint64_t>* ramps)
+    int try_get_gamma(GammaRamps<uint64_t>* ramps) noexcept
     {
       __LIBGAMMA_GET_GAMMA(64);
     }
     
     /**
-     * Get the current gamma ramps for the CRTC.
+     * Get the current gamma ramps for the CRTC, without throwing.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param   ramps  The gamma ramps to fill with the current values.
+     * @return         Zero on success, otherwise the error code.
      */
-    void get_gamma(GammaRamps<float>* ramps)
+    int try_get_gamma(GammaRamps<float>* ramps) noexcept
     {
       __LIBGAMMA_GET_GAMMA(f);
     }
     
     /**
-     * Get the current gamma ramps for the CRTC.
+     * Get the current gamma ramps for the CRTC, without throwing.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param   ramps  The gamma ramps to fill with the current values.
+     * @return         Zero on success, otherwise the error code.
      */
-    void get_gamma(GammaRamps<double>* ramps)
+    int try_get_gamma(GammaRamps<double>* ramps) noexcept
     {
       __LIBGAMMA_GET_GAMMA(d);
     }
@@ -922,72 +1325,242 @@ namespace libgamma
     ramps_.red_size = ramps->red.size;						\
     ramps_.green_size = ramps->green.size;					\
     ramps_.blue_size = ramps->blue.size;					\
+    __LIBGAMMA_SERIALISE(this->partition);					\
+    if ((this->elision != nullptr) &&						\
+	this->elision->unchanged(ramps->depth,					\
+				 ramps_.red, ramps_.red_size * sizeof(*(ramps_.red)),	\
+				 ramps_.green, ramps_.green_size * sizeof(*(ramps_.green)),	\
+				 ramps_.blue, ramps_.blue_size * sizeof(*(ramps_.blue))))	\
+      return 0;									\
+    __LIBGAMMA_PROBE_BEGIN(STATS_SET_GAMMA, this->stats);			\
+    __LIBGAMMA_PROBE_DESCRIBE(this->partition->site->method,			\
+			      this->partition->partition, this->crtc,		\
+			      ramps_.red_size, ramps_.green_size,		\
+			      ramps_.blue_size, ramps->depth);			\
     r = libgamma_crtc_set_gamma_ramps ## AFFIX(this->native, ramps_);		\
+    __LIBGAMMA_PROBE_END(r);							\
     if (r != 0)									\
-      throw create_error(r)
+      {										\
+	if (this->elision != nullptr)						\
+	  this->elision->invalidate();						\
+	return resolve_error(r);						\
+      }										\
+    if (this->elision != nullptr)						\
+      this->elision->applied();							\
+    return 0
     
     /**
-     * Set gamma ramps for the CRTC.
+     * Set gamma ramps for the CRTC, without throwing.
+     * 
+     * @param   ramps  The gamma ramps to apply.
+     * @return         Zero on success, otherwise the error code.
+     */
+    int try_set_gamma(GammaRamps<uint8_t>* ramps) noexcept
+    {
+      __LIBGAMMA_SET_GAMMA(8);
+    }
+    
+    /**
+     * Set gamma ramps for the CRTC, without throwing.
+     * 
+     * @param   ramps  The gamma ramps to apply.
+     * @return         Zero on success, otherwise the error code.
+     */
+    int try_set_gamma(GammaRamps<uint16_t>* ramps) noexcept
+    {
+      __LIBGAMMA_SET_GAMMA(16);
+    }
+    
+    /**
+     * Set gamma ramps for the CRTC, without throwing.
+     * 
+     * @param   ramps  The gamma ramps to apply.
+     * @return         Zero on success, otherwise the error code.
+     */
+    int try_set_gamma(GammaRamps<uint32_t>* ramps) noexcept
+    {
+      __LIBGAMMA_SET_GAMMA(32);
+    }
+    
+    /**
+     * Set gamma ramps for the CRTC, without throwing.
+     * 
+     * @param   ramps  The gamma ramps to apply.
+     * @return         Zero on success, otherwise the error code.
+     */
+    int try_set_gamma(GammaRamps<uint64_t>* ramps) noexcept
+    {
+      __LIBGAMMA_SET_GAMMA(64);
+    }
+    
+    /**
+     * Set gamma ramps for the CRTC, without throwing.
+     * 
+     * @param   ramps  The gamma ramps to apply.
+     * @return         Zero on success, otherwise the error code.
+     */
+    int try_set_gamma(GammaRamps<float>* ramps) noexcept
+    {
+      __LIBGAMMA_SET_GAMMA(f);
+    }
+    
+    /**
+     * Set gamma ramps for the CRTC, without throwing.
+     * 
+     * @param   ramps  The gamma ramps to apply.
+     * @return         Zero on success, otherwise the error code.
+     */
+    int try_set_gamma(GammaRamps<double>* ramps) noexcept
+    {
+      __LIBGAMMA_SET_GAMMA(d);
+    }
+    
+#undef __LIBGAMMA_SET_GAMMA
+    
+    /**
+     * Get the current gamma ramps for the CRTC.
+     * 
+     * @param  ramps  The gamma ramps to fill with the current values.
+     */
+    void get_gamma(GammaRamps<uint8_t>* ramps)
+    {
+      int r = this->try_get_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
+    }
+    
+    /**
+     * Get the current gamma ramps for the CRTC.
+     * 
+     * @param  ramps  The gamma ramps to fill with the current values.
+     */
+    void get_gamma(GammaRamps<uint16_t>* ramps)
+    {
+      int r = this->try_get_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
+    }
+    
+    /**
+     * Get the current gamma ramps for the CRTC.
+     * 
+     * @param  ramps  The gamma ramps to fill with the current values.
+     */
+    void get_gamma(GammaRamps<uint32_t>* ramps)
+    {
+      int r = this->try_get_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
+    }
+    
+    /**
+     * Get the current gamma ramps for the CRTC.
+     * 
+     * @param  ramps  The gamma ramps to fill with the current values.
+     */
+    void get_gamma(GammaRamps<uint64_t>* ramps)
+    {
+      int r = this->try_get_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
+    }
+    
+    /**
+     * Get the current gamma ramps for the CRTC.
+     * 
+     * @param  ramps  The gamma ramps to fill with the current values.
+     */
+    void get_gamma(GammaRamps<float>* ramps)
+    {
+      int r = this->try_get_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
+    }
+    
+    /**
+     * Get the current gamma ramps for the CRTC.
      * 
      * @param  ramps  The gamma ramps to fill with the current values.
      */
+    void get_gamma(GammaRamps<double>* ramps)
+    {
+      int r = this->try_get_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
+    }
+    
+    /**
+     * Set gamma ramps for the CRTC.
+     * 
+     * @param  ramps  The gamma ramps to apply.
+     */
     void set_gamma(GammaRamps<uint8_t>* ramps)
     {
-      __LIBGAMMA_SET_GAMMA(8);
+      int r = this->try_set_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
     }
     
     /**
      * Set gamma ramps for the CRTC.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param  ramps  The gamma ramps to apply.
      */
     void set_gamma(GammaRamps<uint16_t>* ramps)
     {
-      __LIBGAMMA_SET_GAMMA(16);
+      int r = this->try_set_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
     }
     
     /**
      * Set gamma ramps for the CRTC.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param  ramps  The gamma ramps to apply.
      */
     void set_gamma(GammaRamps<uint32_t>* ramps)
     {
-      __LIBGAMMA_SET_GAMMA(32);
+      int r = this->try_set_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
     }
     
     /**
      * Set gamma ramps for the CRTC.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param  ramps  The gamma ramps to apply.
      */
     void set_gamma(GammaRamps<uint64_t>* ramps)
     {
-      __LIBGAMMA_SET_GAMMA(64);
+      int r = this->try_set_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
     }
     
     /**
      * Set gamma ramps for the CRTC.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param  ramps  The gamma ramps to apply.
      */
     void set_gamma(GammaRamps<float>* ramps)
     {
-      __LIBGAMMA_SET_GAMMA(f);
+      int r = this->try_set_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
     }
     
     /**
      * Set gamma ramps for the CRTC.
      * 
-     * @param  ramps  The gamma ramps to fill with the current values.
+     * @param  ramps  The gamma ramps to apply.
      */
     void set_gamma(GammaRamps<double>* ramps)
     {
-      __LIBGAMMA_SET_GAMMA(d);
+      int r = this->try_set_gamma(ramps);
+      if (r != 0)
+	__LIBGAMMA_THROW(r);
     }
     
-#undef __LIBGAMMA_SET_GAMMA
-    
     
     
     /**
@@ -1005,6 +1578,54 @@ namespace libgamma
      */
     libgamma_crtc_state_t* native;
     
+    /**
+     * The memory of the last applied gamma ramps, and the
+     * counters for skipped `set_gamma` calls, `nullptr`
+     * unless enabled with `elide_unchanged`.
+     */
+    GammaElision* elision;
+    
+    /**
+     * The statistics for the native calls made for this CRTC,
+     * `nullptr` if the library was built without statistics.
+     */
+    StatsCounters* stats;
+    
+    /**
+     * The information cached by `cached_information`,
+     * `nullptr` until `cached_information` is called.
+     */
+    CRTCInformation* information_cache;
+    
+    /**
+     * OR:ed identifiers for the fields in `information_cache` that are valid.
+     */
+    int32_t information_cached;
+    
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    CRTC(const CRTC&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    CRTC& operator =(const CRTC&) = delete;
+    
+    /**
+     * Initialise the native state, `partition` and `crtc` must be set.
+     * 
+     * @return  Zero on success, otherwise the error code.
+     */
+    int initialise() noexcept;
+    
+    /**
+     * Storage for freshly read information that
+     * is merged into `information_cache`.
+     */
+    CRTCInformation* information_scratch;
+    
   };
   
 #ifdef __GCC__
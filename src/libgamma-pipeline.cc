@@ -0,0 +1,332 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-pipeline.hh"
+
+#include "libgamma-convert.hh"
+
+#include <cmath>
+
+
+/**
+ * The number of stops that are evaluated at a time,
+ * small enough for the block to stay in the L1 cache.
+ */
+#define LIBGAMMA_PIPELINE_BLOCK  256
+
+
+namespace libgamma
+{
+  /**
+   * Constructor.
+   */
+  RampPipeline::RampPipeline() :
+    stages()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  RampPipeline::~RampPipeline()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Remove all adjustments.
+   * 
+   * @return  This pipeline.
+   */
+  RampPipeline& RampPipeline::clear()
+  {
+    this->stages.clear();
+    return *this;
+  }
+  
+  /**
+   * Add a linear adjustment, merging it with the
+   * last stage if that stage is also linear.
+   * 
+   * @param  factor  The factor for each channel.
+   * @param  offset  The offset for each channel.
+   */
+  void RampPipeline::add_affine(const double factor[3], const double offset[3])
+  {
+    size_t c;
+    if (!this->stages.empty() && (this->stages.back().type == RAMP_STAGE_AFFINE))
+      {
+	/* a(bx + c) + d = (ab)x + (ac + d) */
+	RampStage& last = this->stages.back();
+	for (c = 0; c < 3; c++)
+	  {
+	    last.offset[c] = factor[c] * last.offset[c] + offset[c];
+	    last.factor[c] *= factor[c];
+	  }
+      }
+    else
+      {
+	RampStage stage;
+	stage.type = RAMP_STAGE_AFFINE;
+	for (c = 0; c < 3; c++)
+	  {
+	    stage.factor[c] = factor[c];
+	    stage.offset[c] = offset[c];
+	  }
+	this->stages.push_back(stage);
+      }
+  }
+  
+  /**
+   * Add a brightness adjustment.
+   * 
+   * @param   red    The brightness of the red channel, 1 for no adjustment.
+   * @param   green  The brightness of the green channel, 1 for no adjustment.
+   * @param   blue   The brightness of the blue channel, 1 for no adjustment.
+   * @return         This pipeline.
+   */
+  RampPipeline& RampPipeline::brightness(double red, double green, double blue)
+  {
+    const double factor[3] = { red, green, blue };
+    const double offset[3] = { 0, 0, 0 };
+    this->add_affine(factor, offset);
+    return *this;
+  }
+  
+  /**
+   * Add a brightness adjustment.
+   * 
+   * @param   value  The brightness of all channels, 1 for no adjustment.
+   * @return         This pipeline.
+   */
+  RampPipeline& RampPipeline::brightness(double value)
+  {
+    return this->brightness(value, value, value);
+  }
+  
+  /**
+   * Add a contrast adjustment, around the midpoint 0.5.
+   * 
+   * @param   red    The contrast of the red channel, 1 for no adjustment.
+   * @param   green  The contrast of the green channel, 1 for no adjustment.
+   * @param   blue   The contrast of the blue channel, 1 for no adjustment.
+   * @return         This pipeline.
+   */
+  RampPipeline& RampPipeline::contrast(double red, double green, double blue)
+  {
+    const double factor[3] = { red, green, blue };
+    const double offset[3] = { (1 - red) / 2, (1 - green) / 2, (1 - blue) / 2 };
+    this->add_affine(factor, offset);
+    return *this;
+  }
+  
+  /**
+   * Add a contrast adjustment, around the midpoint 0.5.
+   * 
+   * @param   value  The contrast of all channels, 1 for no adjustment.
+   * @return         This pipeline.
+   */
+  RampPipeline& RampPipeline::contrast(double value)
+  {
+    return this->contrast(value, value, value);
+  }
+  
+  /**
+   * Add a gamma correction.
+   * 
+   * @param   red    The gamma of the red channel, 1 for no adjustment.
+   * @param   green  The gamma of the green channel, 1 for no adjustment.
+   * @param   blue   The gamma of the blue channel, 1 for no adjustment.
+   * @return         This pipeline.
+   */
+  RampPipeline& RampPipeline::gamma(double red, double green, double blue)
+  {
+    RampStage stage;
+    stage.type = RAMP_STAGE_POWER;
+    stage.factor[0] = 1 / red;
+    stage.factor[1] = 1 / green;
+    stage.factor[2] = 1 / blue;
+    stage.offset[0] = stage.offset[1] = stage.offset[2] = 0;
+    this->stages.push_back(stage);
+    return *this;
+  }
+  
+  /**
+   * Add a gamma correction.
+   * 
+   * @param   value  The gamma of all channels, 1 for no adjustment.
+   * @return         This pipeline.
+   */
+  RampPipeline& RampPipeline::gamma(double value)
+  {
+    return this->gamma(value, value, value);
+  }
+  
+  
+  /**
+   * Calculate the linear RGB colour, with Y = 1, of a point
+   * on the Planckian locus, using the cubic spline
+   * approximation by Kim et al.
+   * 
+   * @param  kelvin  The colour temperature, in [1667, 25000].
+   * @param  rgb     Output parameter for the red, green and blue values.
+   */
+  static void planckian_locus(double kelvin, double rgb[3])
+  {
+    double t = 1000 / kelvin, x, y, X, Z;
+    if (kelvin <= 4000)
+      x = ((-0.2661239 * t - 0.2343589) * t + 0.8776956) * t + 0.179910;
+    else
+      x = ((-3.0258469 * t + 2.1070379) * t + 0.2226347) * t + 0.240390;
+    if (kelvin <= 2222)
+      y = ((-1.1063814 * x - 1.34811020) * x + 2.18555832) * x - 0.20219683;
+    else if (kelvin <= 4000)
+      y = ((-0.9549476 * x - 1.37418593) * x + 2.09137015) * x - 0.16748867;
+    else
+      y = (( 3.0817580 * x - 5.87338670) * x + 3.75112997) * x - 0.37001483;
+    X = x / y;
+    Z = (1 - x - y) / y;
+    rgb[0] =  3.2404542 * X - 1.5371385 - 0.4985314 * Z;
+    rgb[1] = -0.9692660 * X + 1.8760108 +  0.0415560 * Z;
+    rgb[2] =  0.0556434 * X - 0.2040259 +  1.0572252 * Z;
+  }
+  
+  /**
+   * Add a colour temperature adjustment. The white point is
+   * approximated from the Planckian locus and is normalised
+   * so that 6500 K is no adjustment and no channel is boosted.
+   * 
+   * @param   kelvin  The colour temperature, in kelvins, it
+   *                  is clamped to [1667, 25000].
+   * @return          This pipeline.
+   */
+  RampPipeline& RampPipeline::temperature(double kelvin)
+  {
+    double rgb[3], neutral[3], max = 0;
+    size_t c;
+    kelvin = kelvin < 1667 ? 1667 : kelvin > 25000 ? 25000 : kelvin;
+    planckian_locus(kelvin, rgb);
+    planckian_locus(6500, neutral);
+    for (c = 0; c < 3; c++)
+      {
+	rgb[c] /= neutral[c];
+	rgb[c] = rgb[c] < 0 ? 0 : rgb[c];
+	max = rgb[c] > max ? rgb[c] : max;
+      }
+    return this->brightness(rgb[0] / max, rgb[1] / max, rgb[2] / max);
+  }
+  
+  
+  /**
+   * Evaluate the pipeline on a block of stops for one channel.
+   * 
+   * @param  stages   The stages of the pipeline.
+   * @param  channel  The index of the channel, 0 for red, 1 for green, 2 for blue.
+   * @param  block    The values to adjust, in place.
+   * @param  n        The number of values in `block`.
+   */
+  static void evaluate_block(const std::vector<RampStage>& stages, size_t channel, double* block, size_t n)
+  {
+    size_t i;
+    for (const RampStage& stage : stages)
+      {
+	double factor = stage.factor[channel];
+	double offset = stage.offset[channel];
+	if (stage.type == RAMP_STAGE_AFFINE)
+	  for (i = 0; i < n; i++)
+	    block[i] = block[i] * factor + offset;
+	else
+	  for (i = 0; i < n; i++)
+	    block[i] = block[i] > 0 ? std::pow(block[i], factor) : 0;
+      }
+    for (i = 0; i < n; i++)
+      block[i] = block[i] < 0 ? 0 : block[i] > 1 ? 1 : block[i];
+  }
+  
+  /**
+   * Evaluate the pipeline for one channel.
+   * 
+   * @param  stages   The stages of the pipeline.
+   * @param  channel  The index of the channel, 0 for red, 1 for green, 2 for blue.
+   * @param  ramp     The ramp to write to, and to read from unless `identity` is set.
+   * @param  identity Whether to start from an identity mapping rather
+   *                  than the current values in `ramp`.
+   */
+  template <typename T>
+  static void evaluate_ramp(const std::vector<RampStage>& stages, size_t channel, Ramp<T>* ramp, bool identity)
+  {
+    double block[LIBGAMMA_PIPELINE_BLOCK];
+    double max = (double)(ramp->size > 1 ? ramp->size - 1 : 1);
+    size_t start, n, i;
+    for (start = 0; start < ramp->size; start += n)
+      {
+	n = ramp->size - start;
+	n = n < LIBGAMMA_PIPELINE_BLOCK ? n : LIBGAMMA_PIPELINE_BLOCK;
+	if (identity)
+	  for (i = 0; i < n; i++)
+	    block[i] = (double)(start + i) / max;
+	else
+	  convert_stops(ramp->ramp + start, block, n);
+	evaluate_block(stages, channel, block, n);
+	convert_stops(block, ramp->ramp + start, n);
+      }
+  }
+  
+  /**
+   * Fill gamma ramps with the result of the pipeline
+   * applied to an identity mapping.
+   * 
+   * @param  ramps  The gamma ramps to fill.
+   */
+  template <typename T>
+  void RampPipeline::render(GammaRamps<T>* ramps) const
+  {
+    evaluate_ramp(this->stages, 0, &(ramps->red), true);
+    evaluate_ramp(this->stages, 1, &(ramps->green), true);
+    evaluate_ramp(this->stages, 2, &(ramps->blue), true);
+  }
+  
+  /**
+   * Apply the pipeline to the current values in gamma ramps.
+   * 
+   * @param  ramps  The gamma ramps to adjust.
+   */
+  template <typename T>
+  void RampPipeline::apply(GammaRamps<T>* ramps) const
+  {
+    evaluate_ramp(this->stages, 0, &(ramps->red), false);
+    evaluate_ramp(this->stages, 1, &(ramps->green), false);
+    evaluate_ramp(this->stages, 2, &(ramps->blue), false);
+  }
+  
+  
+#define __LIBGAMMA_PIPELINE(T)						\
+  template void RampPipeline::render<T>(GammaRamps<T>* ramps) const;	\
+  template void RampPipeline::apply<T>(GammaRamps<T>* ramps) const
+  
+  __LIBGAMMA_PIPELINE(uint8_t);
+  __LIBGAMMA_PIPELINE(uint16_t);
+  __LIBGAMMA_PIPELINE(uint32_t);
+  __LIBGAMMA_PIPELINE(uint64_t);
+  __LIBGAMMA_PIPELINE(float);
+  __LIBGAMMA_PIPELINE(double);
+  
+#undef __LIBGAMMA_PIPELINE
+
+}
+
@@ -0,0 +1,221 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_PIPELINE_HH
+#define LIBGAMMA_PIPELINE_HH
+
+
+#include <vector>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * The kinds of stages in a `RampPipeline`.
+   */
+  enum RampStageType
+    {
+      /**
+       * `value * factor + offset` for each channel.
+       */
+      RAMP_STAGE_AFFINE,
+      
+      /**
+       * `value ^ exponent` for each channel, negative
+       * values are clamped to zero.
+       */
+      RAMP_STAGE_POWER
+    };
+  
+  
+  /**
+   * A stage in a `RampPipeline`.
+   */
+  class RampStage
+  {
+  public:
+    /**
+     * The kind of the stage.
+     */
+    RampStageType type;
+    
+    /**
+     * The factor, for `RAMP_STAGE_AFFINE`, or the exponent, for
+     * `RAMP_STAGE_POWER`, for the red, green and blue channels.
+     */
+    double factor[3];
+    
+    /**
+     * The offset, for `RAMP_STAGE_AFFINE`, for the
+     * red, green and blue channels.
+     */
+    double offset[3];
+    
+  };
+  
+  
+  /**
+   * A chain of adjustments, such as brightness, contrast,
+   * gamma and colour temperature, that is evaluated in a
+   * single pass over the gamma ramps.
+   * 
+   * Adjacent linear adjustments are merged into one stage
+   * when they are added, and the whole chain is applied on
+   * one small block of stops at a time, so that each stop in
+   * the gamma ramps is read and written only once, instead
+   * of once per adjustment. The values are calculated in
+   * double precision and clamped to [0, 1] before they are
+   * converted to the element type of the ramps.
+   */
+  class RampPipeline
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    RampPipeline();
+    
+    /**
+     * Destructor.
+     */
+    ~RampPipeline();
+    
+    /**
+     * Remove all adjustments.
+     * 
+     * @return  This pipeline.
+     */
+    RampPipeline& clear();
+    
+    /**
+     * Add a brightness adjustment.
+     * 
+     * @param   red    The brightness of the red channel, 1 for no adjustment.
+     * @param   green  The brightness of the green channel, 1 for no adjustment.
+     * @param   blue   The brightness of the blue channel, 1 for no adjustment.
+     * @return         This pipeline.
+     */
+    RampPipeline& brightness(double red, double green, double blue);
+    
+    /**
+     * Add a brightness adjustment.
+     * 
+     * @param   value  The brightness of all channels, 1 for no adjustment.
+     * @return         This pipeline.
+     */
+    RampPipeline& brightness(double value);
+    
+    /**
+     * Add a contrast adjustment, around the midpoint 0.5.
+     * 
+     * @param   red    The contrast of the red channel, 1 for no adjustment.
+     * @param   green  The contrast of the green channel, 1 for no adjustment.
+     * @param   blue   The contrast of the blue channel, 1 for no adjustment.
+     * @return         This pipeline.
+     */
+    RampPipeline& contrast(double red, double green, double blue);
+    
+    /**
+     * Add a contrast adjustment, around the midpoint 0.5.
+     * 
+     * @param   value  The contrast of all channels, 1 for no adjustment.
+     * @return         This pipeline.
+     */
+    RampPipeline& contrast(double value);
+    
+    /**
+     * Add a gamma correction.
+     * 
+     * @param   red    The gamma of the red channel, 1 for no adjustment.
+     * @param   green  The gamma of the green channel, 1 for no adjustment.
+     * @param   blue   The gamma of the blue channel, 1 for no adjustment.
+     * @return         This pipeline.
+     */
+    RampPipeline& gamma(double red, double green, double blue);
+    
+    /**
+     * Add a gamma correction.
+     * 
+     * @param   value  The gamma of all channels, 1 for no adjustment.
+     * @return         This pipeline.
+     */
+    RampPipeline& gamma(double value);
+    
+    /**
+     * Add a colour temperature adjustment. The white point is
+     * approximated from the Planckian locus and is normalised
+     * so that 6500 K is no adjustment and no channel is boosted.
+     * 
+     * @param   kelvin  The colour temperature, in kelvins, it
+     *                  is clamped to [1667, 25000].
+     * @return          This pipeline.
+     */
+    RampPipeline& temperature(double kelvin);
+    
+    /**
+     * Fill gamma ramps with the result of the pipeline
+     * applied to an identity mapping.
+     * 
+     * @param  ramps  The gamma ramps to fill.
+     */
+    template <typename T>
+    void render(GammaRamps<T>* ramps) const;
+    
+    /**
+     * Apply the pipeline to the current values in gamma ramps.
+     * 
+     * @param  ramps  The gamma ramps to adjust.
+     */
+    template <typename T>
+    void apply(GammaRamps<T>* ramps) const;
+    
+    
+    
+    /**
+     * The stages of the pipeline, in the order they are evaluated.
+     */
+    std::vector<RampStage> stages;
+  
+  private:
+    /**
+     * Add a linear adjustment, merging it with the
+     * last stage if that stage is also linear.
+     * 
+     * @param  factor  The factor for each channel.
+     * @param  offset  The offset for each channel.
+     */
+    void add_affine(const double factor[3], const double offset[3]);
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,255 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-site-pool.hh"
+
+#include "libgamma-error.hh"
+
+
+namespace libgamma
+{
+  /**
+   * The default health check of a `SitePool`, it opens
+   * and closes the site's first partition.
+   * 
+   * @param   site  The site.
+   * @return        Whether the partition could be opened.
+   */
+  static bool open_first_partition(Site* site)
+  {
+    if (site->partitions_available == 0)
+      return true;
+    Result<Partition*> r = Partition::open(site, 0);
+    delete r.value;
+    return r.ok();
+  }
+  
+  /**
+   * Convert a number of seconds to a duration.
+   * 
+   * @param   seconds  The number of seconds.
+   * @return           The duration.
+   */
+  static std::chrono::steady_clock::duration seconds_to_duration(double seconds)
+  {
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>
+      (std::chrono::duration<double>(seconds));
+  }
+  
+  
+  /**
+   * Constructor.
+   * 
+   * @param  idle_timeout    The number of seconds a site may be unused
+   *                         before it is closed.
+   * @param  check_interval  The number of seconds a health check is
+   *                         trusted, zero to check every time a site
+   *                         is handed out, negative to never check.
+   */
+  SitePool::SitePool(double idle_timeout, double check_interval) :
+    timeout(seconds_to_duration(idle_timeout)),
+    interval(seconds_to_duration(check_interval)),
+    health_check(open_first_partition),
+    hits(0),
+    misses(0),
+    unhealthy(0),
+    entries(),
+    mutex()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  SitePool::~SitePool()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Get a site from the pool, or open it if it is not pooled.
+   * 
+   * @param   method  The adjustment method of the site.
+   * @param   site    The site identifier, `nullptr` for the default site.
+   * @return          The site.
+   */
+  std::shared_ptr<Site> SitePool::acquire(int method, const std::string* site)
+  {
+    std::tuple<int, bool, std::string> key(method, site == nullptr, site == nullptr ? std::string() : *site);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<Site>> expired;
+    std::shared_ptr<Site> rc;
+    std::shared_ptr<Site> opened;
+    bool check = false;
+    
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->collect(now, &expired);
+      auto it = this->entries.find(key);
+      if (it != this->entries.end())
+	{
+	  rc = it->second.site;
+	  it->second.used = now;
+	  if ((this->interval >= std::chrono::steady_clock::duration::zero()) &&
+	      (now - it->second.checked >= this->interval))
+	    {
+	      /* Other threads trust the site whilst it is being checked. */
+	      it->second.checked = now;
+	      check = true;
+	    }
+	}
+    }
+    
+    if ((rc != nullptr) && check && !this->health_check(rc.get()))
+      {
+	this->unhealthy++;
+	this->discard(rc.get());
+	rc = nullptr;
+      }
+    if (rc != nullptr)
+      {
+	this->hits++;
+	return rc;
+      }
+    
+    /* Open the site without holding the lock, as that can take some time. */
+    this->misses++;
+    Result<Site*> r = Site::open(method, site == nullptr ? nullptr : new std::string(*site));
+    if (!r.ok())
+      __LIBGAMMA_THROW(r.error);
+    opened = std::shared_ptr<Site>(r.value);
+    
+    now = std::chrono::steady_clock::now();
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      SitePoolEntry& entry = this->entries[key];
+      /* Use the site another thread opened in the meantime, if any. */
+      if (entry.site == nullptr)
+	{
+	  entry.site = opened;
+	  entry.checked = now;
+	}
+      entry.used = now;
+      rc = entry.site;
+    }
+    return rc;
+  }
+  
+  /**
+   * Remove a site from the pool, for example because it has
+   * failed. It stays open until it is released by all holders.
+   * 
+   * @param   site  The site.
+   * @return        Whether the site was pooled.
+   */
+  bool SitePool::discard(const Site* site)
+  {
+    std::shared_ptr<Site> discarded;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (auto it = this->entries.begin(); it != this->entries.end(); ++it)
+      if (it->second.site.get() == site)
+	{
+	  discarded.swap(it->second.site);
+	  this->entries.erase(it);
+	  return true;
+	}
+    return false;
+  }
+  
+  /**
+   * Close the sites that have been idle for
+   * at least the idle timeout.
+   * 
+   * @return  The number of closed sites.
+   */
+  size_t SitePool::expire()
+  {
+    std::vector<std::shared_ptr<Site>> expired;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->collect(std::chrono::steady_clock::now(), &expired);
+  }
+  
+  /**
+   * Remove all sites from the pool.
+   */
+  void SitePool::clear()
+  {
+    std::map<std::tuple<int, bool, std::string>, SitePoolEntry> cleared;
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.swap(cleared);
+  }
+  
+  /**
+   * Get the number of pooled sites.
+   * 
+   * @return  The number of pooled sites.
+   */
+  size_t SitePool::size() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->entries.size();
+  }
+  
+  /**
+   * Get the pool that is used when no pool is specified.
+   * It is never destroyed.
+   * 
+   * @return  The shared pool.
+   */
+  SitePool* SitePool::shared()
+  {
+    static SitePool* pool = new SitePool();
+    return pool;
+  }
+  
+  /**
+   * Close the sites that have been idle for at least
+   * the idle timeout, `mutex` must be held.
+   * 
+   * @param   now      The current time.
+   * @param   expired  Output parameter for the sites to close, they
+   *                   are moved out of the pool so that they can be
+   *                   closed after `mutex` has been released.
+   * @return           The number of expired sites.
+   */
+  size_t SitePool::collect(std::chrono::steady_clock::time_point now,
+			   std::vector<std::shared_ptr<Site>>* expired)
+  {
+    size_t n = 0;
+    auto it = this->entries.begin();
+    while (it != this->entries.end())
+      if (it->second.site.use_count() > 1)
+	{
+	  /* Sites can only be handed out with `mutex` held,
+	   * so a site that only the pool holds stays idle. */
+	  it->second.used = now;
+	  ++it;
+	}
+      else if (now - it->second.used >= this->timeout)
+	{
+	  expired->push_back(std::move(it->second.site));
+	  it = this->entries.erase(it);
+	  n++;
+	}
+      else
+	++it;
+    return n;
+  }
+  
+}
+
@@ -0,0 +1,246 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_SITE_POOL_HH
+#define LIBGAMMA_SITE_POOL_HH
+
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * A site in a `SitePool`.
+   */
+  class SitePoolEntry
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    SitePoolEntry() :
+      site(),
+      used(),
+      checked()
+    {
+      /* Do nothing. */
+    }
+    
+    
+    
+    /**
+     * The site, the pool holds one reference.
+     */
+    std::shared_ptr<Site> site;
+    
+    /**
+     * When the site was last handed out, or
+     * last seen in use by `SitePool::expire`.
+     */
+    std::chrono::steady_clock::time_point used;
+    
+    /**
+     * When the site last passed the health check.
+     */
+    std::chrono::steady_clock::time_point checked;
+    
+  };
+  
+  
+  /**
+   * A pool of shared sites, by adjustment method and site
+   * identifier, so that the connection to a display server
+   * is set up once rather than each time a site is needed.
+   * 
+   * Sites are handed out as reference counted pointers and
+   * are used concurrently by all holders, see `Site` for
+   * their thread-safety. A site that has had no holders
+   * other than the pool for at least the idle timeout is
+   * closed by `expire`, which `acquire` also calls. Before
+   * a pooled site is handed out it is health checked, if
+   * it has not been checked within the check interval, and
+   * replaced with a new site if the check fails. The pool
+   * is thread-safe.
+   */
+  class SitePool
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  idle_timeout    The number of seconds a site may be unused
+     *                         before it is closed.
+     * @param  check_interval  The number of seconds a health check is
+     *                         trusted, zero to check every time a site
+     *                         is handed out, negative to never check.
+     */
+    SitePool(double idle_timeout = 60, double check_interval = 5);
+    
+    /**
+     * Destructor.
+     * 
+     * Sites that are still held outside
+     * the pool stay open until released.
+     */
+    ~SitePool();
+    
+    /**
+     * Get a site from the pool, or open it if it is not pooled.
+     * 
+     * @param   method  The adjustment method of the site.
+     * @param   site    The site identifier, `nullptr` for the default site.
+     * @return          The site.
+     */
+    std::shared_ptr<Site> acquire(int method, const std::string* site = nullptr);
+    
+    /**
+     * Remove a site from the pool, for example because it has
+     * failed. It stays open until it is released by all holders.
+     * 
+     * @param   site  The site.
+     * @return        Whether the site was pooled.
+     */
+    bool discard(const Site* site);
+    
+    /**
+     * Close the sites that have been idle for
+     * at least the idle timeout.
+     * 
+     * @return  The number of closed sites.
+     */
+    size_t expire();
+    
+    /**
+     * Remove all sites from the pool.
+     */
+    void clear();
+    
+    /**
+     * Get the number of pooled sites.
+     * 
+     * @return  The number of pooled sites.
+     */
+    size_t size() const;
+    
+    /**
+     * Get the pool that is used when no pool is specified.
+     * It is never destroyed.
+     * 
+     * @return  The shared pool.
+     */
+    static SitePool* shared();
+    
+    
+    
+    /**
+     * The time a site may be unused before it is closed.
+     */
+    std::chrono::steady_clock::duration timeout;
+    
+    /**
+     * The time a health check is trusted, negative to never check.
+     */
+    std::chrono::steady_clock::duration interval;
+    
+    /**
+     * The health check, it returns whether a site still works.
+     * The default opens and closes the site's first partition,
+     * which makes a round-trip to the display server. Set it
+     * before the pool is used.
+     */
+    std::function<bool(Site*)> health_check;
+    
+    /**
+     * The number of sites that were handed out from the pool.
+     */
+    std::atomic<uint64_t> hits;
+    
+    /**
+     * The number of sites that had to be opened.
+     */
+    std::atomic<uint64_t> misses;
+    
+    /**
+     * The number of sites that failed the health check.
+     */
+    std::atomic<uint64_t> unhealthy;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    SitePool(const SitePool&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    SitePool& operator =(const SitePool&) = delete;
+    
+    /**
+     * Close the sites that have been idle for at least
+     * the idle timeout, `mutex` must be held.
+     * 
+     * @param   now      The current time.
+     * @param   expired  Output parameter for the sites to close, they
+     *                   are moved out of the pool so that they can be
+     *                   closed after `mutex` has been released.
+     * @return           The number of expired sites.
+     */
+    size_t collect(std::chrono::steady_clock::time_point now,
+		   std::vector<std::shared_ptr<Site>>* expired);
+    
+    /**
+     * The sites, by adjustment method, whether the site is
+     * the default site, and the site identifier.
+     */
+    std::map<std::tuple<int, bool, std::string>, SitePoolEntry> entries;
+    
+    /**
+     * Guards `entries`.
+     */
+    mutable std::mutex mutex;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
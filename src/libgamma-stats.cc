@@ -0,0 +1,172 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-stats.hh"
+
+
+namespace libgamma
+{
+  /**
+   * Get an upper bound of a percentile of the latency.
+   * 
+   * @param   p  The percentile, in [0, 100].
+   * @return     The upper bound of the latency, in nanoseconds,
+   *             of the histogram bucket with the percentile,
+   *             zero if there have been no calls.
+   */
+  uint64_t OperationStats::percentile(double p) const
+  {
+    uint64_t total = 0, target, sum = 0;
+    size_t i;
+    for (i = 0; i < LIBGAMMA_STATS_BUCKETS; i++)
+      total += this->histogram[i];
+    if (total == 0)
+      return 0;
+    target = (uint64_t)(p / 100 * (double)total + 0.5);
+    target = target < 1 ? 1 : target;
+    for (i = 0; i < LIBGAMMA_STATS_BUCKETS - 1; i++)
+      if ((sum += this->histogram[i]) >= target)
+	break;
+    return (uint64_t)1 << (i + 1);
+  }
+  
+  /**
+   * Get the mean latency.
+   * 
+   * @return  The mean latency, in nanoseconds, zero
+   *          if there have been no calls.
+   */
+  uint64_t OperationStats::mean() const
+  {
+    return this->calls == 0 ? 0 : this->total_ns / this->calls;
+  }
+  
+  
+  /**
+   * Constructor.
+   */
+  StatsCounters::StatsCounters() :
+    calls(),
+    errors(),
+    total_ns(),
+    histogram()
+  {
+    this->reset();
+  }
+  
+  /**
+   * Destructor.
+   */
+  StatsCounters::~StatsCounters()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Record a call.
+   * 
+   * @param  operation  The operation.
+   * @param  ns         The latency, in nanoseconds.
+   * @param  failed     Whether the call failed.
+   */
+  void StatsCounters::record(StatsOperation operation, uint64_t ns, bool failed)
+  {
+    size_t bucket = 0;
+#ifdef __GCC__
+    if (ns > 1)
+      bucket = (size_t)(63 - __builtin_clzll(ns));
+    bucket = bucket < LIBGAMMA_STATS_BUCKETS - 1 ? bucket : LIBGAMMA_STATS_BUCKETS - 1;
+#else
+    while ((bucket < LIBGAMMA_STATS_BUCKETS - 1) && (ns >> (bucket + 1)))
+      bucket++;
+#endif
+    this->calls[operation].fetch_add(1, std::memory_order_relaxed);
+    if (failed)
+      this->errors[operation].fetch_add(1, std::memory_order_relaxed);
+    this->total_ns[operation].fetch_add(ns, std::memory_order_relaxed);
+    this->histogram[operation][bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+  
+  /**
+   * Take a snapshot of the counters. Counters updated whilst
+   * the snapshot is taken may or may not be included.
+   * 
+   * @param  output  Output parameter for the snapshot.
+   */
+  void StatsCounters::snapshot(Stats* output) const
+  {
+    size_t op, i;
+    for (op = 0; op < STATS_OPERATION_COUNT; op++)
+      {
+	OperationStats& stats = output->operations[op];
+	stats.calls = this->calls[op].load(std::memory_order_relaxed);
+	stats.errors = this->errors[op].load(std::memory_order_relaxed);
+	stats.total_ns = this->total_ns[op].load(std::memory_order_relaxed);
+	for (i = 0; i < LIBGAMMA_STATS_BUCKETS; i++)
+	  stats.histogram[i] = this->histogram[op][i].load(std::memory_order_relaxed);
+      }
+  }
+  
+  /**
+   * Set all counters to zero.
+   */
+  void StatsCounters::reset()
+  {
+    size_t op, i;
+    for (op = 0; op < STATS_OPERATION_COUNT; op++)
+      {
+	this->calls[op].store(0, std::memory_order_relaxed);
+	this->errors[op].store(0, std::memory_order_relaxed);
+	this->total_ns[op].store(0, std::memory_order_relaxed);
+	for (i = 0; i < LIBGAMMA_STATS_BUCKETS; i++)
+	  this->histogram[op][i].store(0, std::memory_order_relaxed);
+      }
+  }
+  
+  
+  /**
+   * Get the counters for all sites, partitions and CRTC:s.
+   * 
+   * @return  The global counters.
+   */
+  StatsCounters& global_stats_counters()
+  {
+    static StatsCounters* counters = new StatsCounters();
+    return *counters;
+  }
+  
+  /**
+   * Take a snapshot of the statistics for all sites, partitions and CRTC:s.
+   * 
+   * @param  output  Output parameter for the snapshot.
+   */
+  void global_statistics(Stats* output)
+  {
+    global_stats_counters().snapshot(output);
+  }
+  
+  /**
+   * Reset the statistics for all sites, partitions and CRTC:s,
+   * the statistics of individual CRTC:s are not reset.
+   */
+  void reset_global_statistics()
+  {
+    global_stats_counters().reset();
+  }
+  
+}
+
@@ -0,0 +1,260 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_STATS_HH
+#define LIBGAMMA_STATS_HH
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+/**
+ * The number of buckets in the latency histograms. Bucket
+ * `i` counts calls that took [2 ^ i, 2 ^ (i + 1)) nanoseconds,
+ * except the last bucket that also counts all slower calls.
+ */
+#define LIBGAMMA_STATS_BUCKETS  32
+
+
+
+namespace libgamma
+{
+  /**
+   * Native operations that statistics are kept for.
+   */
+  enum StatsOperation
+    {
+      /**
+       * `CRTC::get_gamma`.
+       */
+      STATS_GET_GAMMA,
+      
+      /**
+       * `CRTC::set_gamma`, calls elided by
+       * `CRTC::elide_unchanged` are not counted.
+       */
+      STATS_SET_GAMMA,
+      
+      /**
+       * `CRTC::information`.
+       */
+      STATS_INFORMATION,
+      
+      /**
+       * `Site::restore`, `Partition::restore` and `CRTC::restore`.
+       */
+      STATS_RESTORE,
+      
+      /**
+       * The `Site` constructor.
+       */
+      STATS_SITE_INITIALISE,
+      
+      /**
+       * The `Partition` constructor.
+       */
+      STATS_PARTITION_INITIALISE,
+      
+      /**
+       * The `CRTC` constructor.
+       */
+      STATS_CRTC_INITIALISE,
+      
+      /**
+       * The number of operations.
+       */
+      STATS_OPERATION_COUNT
+    };
+  
+  
+  /**
+   * A snapshot of the statistics for an operation.
+   */
+  class OperationStats
+  {
+  public:
+    /**
+     * Get an upper bound of a percentile of the latency.
+     * 
+     * @param   p  The percentile, in [0, 100].
+     * @return     The upper bound of the latency, in nanoseconds,
+     *             of the histogram bucket with the percentile,
+     *             zero if there have been no calls.
+     */
+    uint64_t percentile(double p) const __attribute__((pure));
+    
+    /**
+     * Get the mean latency.
+     * 
+     * @return  The mean latency, in nanoseconds, zero
+     *          if there have been no calls.
+     */
+    uint64_t mean() const __attribute__((pure));
+    
+    
+    
+    /**
+     * The number of calls.
+     */
+    uint64_t calls;
+    
+    /**
+     * The number of calls that failed.
+     */
+    uint64_t errors;
+    
+    /**
+     * The total latency of all calls, in nanoseconds.
+     */
+    uint64_t total_ns;
+    
+    /**
+     * The number of calls per latency range,
+     * see `LIBGAMMA_STATS_BUCKETS`.
+     */
+    uint64_t histogram[LIBGAMMA_STATS_BUCKETS];
+    
+  };
+  
+  
+  /**
+   * A snapshot of the statistics for all operations.
+   */
+  class Stats
+  {
+  public:
+    /**
+     * The statistics for each operation,
+     * indexed by `StatsOperation`.
+     */
+    OperationStats operations[STATS_OPERATION_COUNT];
+    
+  };
+  
+  
+  /**
+   * Live statistics counters, updated with
+   * relaxed atomic operations and without locks.
+   */
+  class StatsCounters
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    StatsCounters();
+    
+    /**
+     * Destructor.
+     */
+    ~StatsCounters();
+    
+    /**
+     * Record a call.
+     * 
+     * @param  operation  The operation.
+     * @param  ns         The latency, in nanoseconds.
+     * @param  failed     Whether the call failed.
+     */
+    void record(StatsOperation operation, uint64_t ns, bool failed);
+    
+    /**
+     * Take a snapshot of the counters. Counters updated whilst
+     * the snapshot is taken may or may not be included.
+     * 
+     * @param  output  Output parameter for the snapshot.
+     */
+    void snapshot(Stats* output) const;
+    
+    /**
+     * Set all counters to zero.
+     */
+    void reset();
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    StatsCounters(const StatsCounters&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    StatsCounters& operator =(const StatsCounters&) = delete;
+    
+    
+    
+    /**
+     * The number of calls per operation.
+     */
+    std::atomic<uint64_t> calls[STATS_OPERATION_COUNT];
+    
+    /**
+     * The number of failed calls per operation.
+     */
+    std::atomic<uint64_t> errors[STATS_OPERATION_COUNT];
+    
+    /**
+     * The total latency per operation, in nanoseconds.
+     */
+    std::atomic<uint64_t> total_ns[STATS_OPERATION_COUNT];
+    
+    /**
+     * The latency histograms per operation.
+     */
+    std::atomic<uint64_t> histogram[STATS_OPERATION_COUNT][LIBGAMMA_STATS_BUCKETS];
+    
+  };
+  
+  
+  /**
+   * Get the counters for all sites, partitions and CRTC:s.
+   * 
+   * @return  The global counters.
+   */
+  StatsCounters& global_stats_counters();
+  
+  /**
+   * Take a snapshot of the statistics for all sites, partitions and CRTC:s.
+   * 
+   * @param  output  Output parameter for the snapshot.
+   */
+  void global_statistics(Stats* output);
+  
+  /**
+   * Reset the statistics for all sites, partitions and CRTC:s,
+   * the statistics of individual CRTC:s are not reset.
+   */
+  void reset_global_statistics();
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -0,0 +1,315 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-topology.hh"
+
+#include "libgamma-batch.hh"
+#include "libgamma-error.hh"
+#include "libgamma-hash.hh"
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+
+
+namespace libgamma
+{
+  /**
+   * Calculate the hash of the fields in
+   * `LIBGAMMA_TOPOLOGY_PROBE_FIELDS` of CRTC information.
+   * 
+   * @param   info  The CRTC information.
+   * @return        The hash.
+   */
+  static uint64_t fingerprint(const CRTCInformation& info)
+  {
+    int64_t scalars[4] = { info.active, info.active_error, info.edid_error, info.connector_name_error };
+    uint64_t hash = hash_bytes(scalars, sizeof(scalars));
+    if (info.edid != nullptr)
+      hash = hash_bytes(info.edid, info.edid_length, hash);
+    if (info.connector_name != nullptr)
+      hash = hash_bytes(info.connector_name->data(), info.connector_name->size(), hash);
+    return hash;
+  }
+  
+  
+  /**
+   * Constructor, builds the topology.
+   * 
+   * @param  adjustment_method  The adjustment method.
+   * @param  site_name          The site, `nullptr` for the default site, it
+   *                            will be deleted when the topology is destroyed.
+   * @param  info_fields        The CRTC information fields to read.
+   * @param  workers            The worker pool to use, `nullptr` for the shared pool.
+   */
+  Topology::Topology(int adjustment_method, std::string* site_name, int32_t info_fields,
+		     WorkerPool* workers) :
+    site(nullptr),
+    partitions(nullptr),
+    partition_count(0),
+    crtcs(nullptr),
+    crtc_count(0),
+    fields(info_fields | LIBGAMMA_TOPOLOGY_PROBE_FIELDS),
+    generation(0),
+    pool(workers == nullptr ? WorkerPool::shared() : workers)
+  {
+    size_t p;
+    try
+      {
+	this->site = new Site(adjustment_method, site_name);
+	
+	/* Partitions are created in order, they share the site. */
+	this->partitions = new TopologyPartition[this->site->partitions_available]();
+	for (p = 0; p < this->site->partitions_available; p++)
+	  {
+	    TopologyPartition& partition = this->partitions[p];
+	    partition.partition = new Partition(this->site, p);
+	    partition.first_crtc = this->crtc_count;
+	    partition.crtc_count = partition.partition->crtcs_available;
+	    this->partition_count++;
+	    this->crtc_count += partition.crtc_count;
+	  }
+	
+	this->crtcs = new TopologyCRTC[this->crtc_count]();
+	this->for_each_partition([this](size_t index)
+				 {
+				   TopologyPartition& partition = this->partitions[index];
+				   size_t i;
+				   for (i = 0; i < partition.crtc_count; i++)
+				     {
+				       TopologyCRTC& crtc = this->crtcs[partition.first_crtc + i];
+				       crtc.crtc = new CRTC(partition.partition, i);
+				       crtc.info = new CRTCInformation();
+				       crtc.crtc->information(crtc.info, this->fields);
+				       crtc.fingerprint = fingerprint(*(crtc.info));
+				     }
+				   return 0;
+				 });
+      }
+    catch (...)
+      {
+	this->destroy();
+	throw;
+      }
+  }
+  
+  /**
+   * Destructor.
+   */
+  Topology::~Topology()
+  {
+    this->destroy();
+  }
+  
+  /**
+   * Delete the partitions and CRTC:s.
+   */
+  void Topology::destroy()
+  {
+    size_t i;
+    if (this->crtcs != nullptr)
+      for (i = 0; i < this->crtc_count; i++)
+	{
+	  delete this->crtcs[i].info;
+	  delete this->crtcs[i].crtc;
+	}
+    if (this->partitions != nullptr)
+      for (i = 0; i < this->partition_count; i++)
+	delete this->partitions[i].partition;
+    delete[] this->crtcs;
+    delete[] this->partitions;
+    delete this->site;
+    this->crtcs = nullptr;
+    this->partitions = nullptr;
+    this->site = nullptr;
+    this->crtc_count = this->partition_count = 0;
+  }
+  
+  /**
+   * Run a function for each partition, on the worker pool,
+   * in parallel where the adjustment method allows it, and
+   * wait for all of them to return.
+   * 
+   * @param  function  The function, it is given the index of
+   *                   the partition, and returns zero or an
+   *                   error code.
+   */
+  void Topology::for_each_partition(std::function<int(size_t)> function)
+  {
+    size_t remaining = this->partition_count;
+    std::mutex mutex;
+    std::condition_variable condition;
+    int error = 0;
+    size_t p;
+    
+    for (p = 0; p < this->partition_count; p++)
+      this->pool->submit(partition_queue_key(this->partitions[p].partition),
+			 [p, &function, &error, &remaining, &mutex, &condition]
+			 {
+			   int r;
+			   try
+			     {
+			       r = function(p);
+			     }
+			   catch (const LibgammaException& e)
+			     {
+			       r = e.error_code;
+			     }
+			   catch (const std::bad_alloc&)
+			     {
+			       r = ENOMEM;
+			     }
+			   std::lock_guard<std::mutex> lock(mutex);
+			   if (error == 0)
+			     error = r;
+			   if (--remaining == 0)
+			     condition.notify_all();
+			 });
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&remaining] { return remaining == 0; });
+    if (error != 0)
+      throw create_error(error);
+  }
+  
+  /**
+   * Read the fields in `LIBGAMMA_TOPOLOGY_PROBE_FIELDS` of every
+   * CRTC, and reread all fields of those where they have changed.
+   * The information cached by `CRTC::cached_information` is
+   * invalidated for changed CRTC:s. The generation is incremented
+   * if any CRTC has changed.
+   * 
+   * The number of partitions and CRTC:s is fixed when the site and
+   * partitions are opened, so added or removed graphics cards and
+   * CRTC:s are only found if `rescan` is set. That opens a new site
+   * and its partitions to count them, and if a count has changed,
+   * the whole topology is rebuilt, which replaces all `Site`,
+   * `Partition` and `CRTC` objects in it.
+   * 
+   * @param   rescan  Whether to check for added or removed
+   *                  partitions and CRTC:s.
+   * @return          Whether any CRTC has changed.
+   */
+  bool Topology::refresh(bool rescan)
+  {
+    uint64_t next = this->generation + 1;
+    std::atomic<bool> changed(false);
+    size_t c;
+    
+    if (rescan && this->counts_changed())
+      {
+	/* Build the new topology first, so that
+	 * nothing is changed if that fails. */
+	std::string* site_name = this->site->site == nullptr ? nullptr : new std::string(*(this->site->site));
+	Topology rebuilt(this->site->method, site_name, this->fields, this->pool);
+	std::swap(this->site, rebuilt.site);
+	std::swap(this->partitions, rebuilt.partitions);
+	std::swap(this->partition_count, rebuilt.partition_count);
+	std::swap(this->crtcs, rebuilt.crtcs);
+	std::swap(this->crtc_count, rebuilt.crtc_count);
+	for (c = 0; c < this->crtc_count; c++)
+	  this->crtcs[c].generation = next;
+	this->generation = next;
+	return true;
+      }
+    
+    this->for_each_partition([this, next, &changed](size_t index)
+			     {
+			       TopologyPartition& partition = this->partitions[index];
+			       size_t i;
+			       for (i = 0; i < partition.crtc_count; i++)
+				 {
+				   TopologyCRTC& crtc = this->crtcs[partition.first_crtc + i];
+				   CRTCInformation probe;
+				   CRTCInformation* info;
+				   crtc.crtc->information(&probe, LIBGAMMA_TOPOLOGY_PROBE_FIELDS);
+				   if (fingerprint(probe) == crtc.fingerprint)
+				     continue;
+				   crtc.crtc->invalidate_information();
+				   info = new CRTCInformation();
+				   try
+				     {
+				       crtc.crtc->information(info, this->fields);
+				     }
+				   catch (...)
+				     {
+				       delete info;
+				       throw;
+				     }
+				   delete crtc.info;
+				   crtc.info = info;
+				   crtc.fingerprint = fingerprint(*info);
+				   crtc.generation = next;
+				   changed = true;
+				 }
+			       return 0;
+			     });
+    
+    if (changed)
+      this->generation = next;
+    return changed;
+  }
+  
+  /**
+   * Check whether the number of partitions,
+   * or of CRTC:s in any partition, has changed.
+   * 
+   * @return  Whether any count has changed.
+   */
+  bool Topology::counts_changed()
+  {
+    std::string* site_name = this->site->site == nullptr ? nullptr : new std::string(*(this->site->site));
+    Site fresh(this->site->method, site_name);
+    size_t p;
+    if (fresh.partitions_available != this->partition_count)
+      return true;
+    for (p = 0; p < this->partition_count; p++)
+      {
+	Partition partition(&fresh, p);
+	if (partition.crtcs_available != this->partitions[p].crtc_count)
+	  return true;
+      }
+    return false;
+  }
+  
+  /**
+   * Get a partition.
+   * 
+   * @param   index  The index of the partition.
+   * @return         The partition.
+   */
+  const TopologyPartition& Topology::partition(size_t index) const
+  {
+    return this->partitions[index];
+  }
+  
+  /**
+   * Get a CRTC in a partition.
+   * 
+   * @param   partition_index  The index of the partition.
+   * @param   crtc_index       The index of the CRTC in the partition.
+   * @return                   The CRTC.
+   */
+  const TopologyCRTC& Topology::crtc(size_t partition_index, size_t crtc_index) const
+  {
+    return this->crtcs[this->partitions[partition_index].first_crtc + crtc_index];
+  }
+  
+}
+
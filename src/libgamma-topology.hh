@@ -0,0 +1,258 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_TOPOLOGY_HH
+#define LIBGAMMA_TOPOLOGY_HH
+
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "libgamma-method.hh"
+#include "libgamma-executor.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+/**
+ * The CRTC information fields that `Topology::refresh` reads
+ * for every CRTC to find out whether the CRTC has changed.
+ */
+#define LIBGAMMA_TOPOLOGY_PROBE_FIELDS  \
+  (LIBGAMMA_CRTC_INFO_ACTIVE | LIBGAMMA_CRTC_INFO_EDID | LIBGAMMA_CRTC_INFO_CONNECTOR_NAME)
+
+
+
+namespace libgamma
+{
+  /**
+   * A CRTC in a `Topology`.
+   */
+  class TopologyCRTC
+  {
+  public:
+    /**
+     * The CRTC.
+     */
+    CRTC* crtc;
+    
+    /**
+     * Information about the CRTC.
+     */
+    CRTCInformation* info;
+    
+    /**
+     * A hash of the fields in `LIBGAMMA_TOPOLOGY_PROBE_FIELDS`.
+     */
+    uint64_t fingerprint;
+    
+    /**
+     * The generation of the topology in
+     * which `info` was last changed.
+     */
+    uint64_t generation;
+    
+  };
+  
+  
+  /**
+   * A partition in a `Topology`.
+   */
+  class TopologyPartition
+  {
+  public:
+    /**
+     * The partition.
+     */
+    Partition* partition;
+    
+    /**
+     * The index, in `Topology::crtcs`, of the partition's first CRTC.
+     */
+    size_t first_crtc;
+    
+    /**
+     * The number of CRTC:s in the partition.
+     */
+    size_t crtc_count;
+    
+  };
+  
+  
+  /**
+   * A snapshot of a site, its partitions and their CRTC:s,
+   * with information about each CRTC.
+   * 
+   * The snapshot is built once, with the partitions populated in
+   * parallel where the adjustment method allows it, and is then
+   * kept up to date with `refresh`, which only rereads the full
+   * information of CRTC:s that have changed. The partitions and
+   * CRTC:s are stored in two flat arrays. The topology must not
+   * be read whilst it is being refreshed. Added or removed graphics
+   * cards and CRTC:s are only picked up by `refresh(true)`.
+   */
+  class Topology
+  {
+  public:
+    /**
+     * Constructor, builds the topology.
+     * 
+     * @param  adjustment_method  The adjustment method.
+     * @param  site_name          The site, `nullptr` for the default site, it
+     *                            will be deleted when the topology is destroyed.
+     * @param  info_fields        The CRTC information fields to read.
+     * @param  workers            The worker pool to use, `nullptr` for the shared pool.
+     */
+    Topology(int adjustment_method, std::string* site_name = nullptr, int32_t info_fields = ~0,
+	     WorkerPool* workers = nullptr);
+    
+    /**
+     * Destructor.
+     */
+    ~Topology();
+    
+    /**
+     * Read the fields in `LIBGAMMA_TOPOLOGY_PROBE_FIELDS` of every
+     * CRTC, and reread all fields of those where they have changed.
+     * The information cached by `CRTC::cached_information` is
+     * invalidated for changed CRTC:s. The generation is incremented
+     * if any CRTC has changed.
+     * 
+     * The number of partitions and CRTC:s is fixed when the site and
+     * partitions are opened, so added or removed graphics cards and
+     * CRTC:s are only found if `rescan` is set. That opens a new site
+     * and its partitions to count them, and if a count has changed,
+     * the whole topology is rebuilt, which replaces all `Site`,
+     * `Partition` and `CRTC` objects in it.
+     * 
+     * @param   rescan  Whether to check for added or removed
+     *                  partitions and CRTC:s.
+     * @return          Whether any CRTC has changed.
+     */
+    bool refresh(bool rescan = false);
+    
+    /**
+     * Get a partition.
+     * 
+     * @param   index  The index of the partition.
+     * @return         The partition.
+     */
+    const TopologyPartition& partition(size_t index) const __attribute__((pure));
+    
+    /**
+     * Get a CRTC in a partition.
+     * 
+     * @param   partition_index  The index of the partition.
+     * @param   crtc_index       The index of the CRTC in the partition.
+     * @return                   The CRTC.
+     */
+    const TopologyCRTC& crtc(size_t partition_index, size_t crtc_index) const __attribute__((pure));
+    
+    
+    
+    /**
+     * The site.
+     */
+    Site* site;
+    
+    /**
+     * The partitions.
+     */
+    TopologyPartition* partitions;
+    
+    /**
+     * The number of elements in `partitions`.
+     */
+    size_t partition_count;
+    
+    /**
+     * The CRTC:s of all partitions, grouped by partition.
+     */
+    TopologyCRTC* crtcs;
+    
+    /**
+     * The number of elements in `crtcs`.
+     */
+    size_t crtc_count;
+    
+    /**
+     * The CRTC information fields that are read.
+     */
+    int32_t fields;
+    
+    /**
+     * Incremented each time the topology changes, starting at zero.
+     */
+    uint64_t generation;
+    
+    /**
+     * The worker pool that is used.
+     */
+    WorkerPool* pool;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    Topology(const Topology&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    Topology& operator =(const Topology&) = delete;
+    
+    /**
+     * Run a function for each partition, on the worker pool,
+     * in parallel where the adjustment method allows it, and
+     * wait for all of them to return.
+     * 
+     * @param  function  The function, it is given the index of
+     *                   the partition, and returns zero or an
+     *                   error code.
+     */
+    void for_each_partition(std::function<int(size_t)> function);
+    
+    /**
+     * Delete the partitions and CRTC:s.
+     */
+    void destroy();
+    
+    /**
+     * Check whether the number of partitions,
+     * or of CRTC:s in any partition, has changed.
+     * 
+     * @return  Whether any count has changed.
+     */
+    bool counts_changed();
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
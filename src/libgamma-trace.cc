@@ -0,0 +1,226 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-trace.hh"
+
+#include <functional>
+#include <thread>
+#include <unistd.h>
+
+
+namespace libgamma
+{
+  /**
+   * Destructor.
+   */
+  TraceHook::~TraceHook()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Called before a native call.
+   * 
+   * @param  event  The call, without `result` and `duration_ns`.
+   */
+  void TraceHook::before(const TraceEvent& event)
+  {
+    (void) event;
+  }
+  
+  
+  /**
+   * The installed trace hook, `nullptr` if none.
+   * Use `set_trace_hook` to change it.
+   */
+  std::atomic<TraceHook*> trace_hook(nullptr);
+  
+  /**
+   * Install a trace hook. The hook may be called from any thread
+   * and must remain valid until no native call that started
+   * whilst it was installed is running.
+   * 
+   * @param   hook  The hook, `nullptr` to remove the current hook.
+   * @return        The previously installed hook.
+   */
+  TraceHook* set_trace_hook(TraceHook* hook)
+  {
+    return trace_hook.exchange(hook, std::memory_order_acq_rel);
+  }
+  
+  /**
+   * Get the name of an operation.
+   * 
+   * @param   operation  The operation.
+   * @return             The name of the operation, for example "set_gamma".
+   */
+  const char* operation_name(StatsOperation operation)
+  {
+    switch (operation)
+      {
+      case STATS_GET_GAMMA:             return "get_gamma";
+      case STATS_SET_GAMMA:             return "set_gamma";
+      case STATS_INFORMATION:           return "information";
+      case STATS_RESTORE:               return "restore";
+      case STATS_SITE_INITIALISE:       return "site_initialise";
+      case STATS_PARTITION_INITIALISE:  return "partition_initialise";
+      case STATS_CRTC_INITIALISE:       return "crtc_initialise";
+      default:
+	return "unknown";
+      }
+  }
+  
+  
+  /**
+   * Describe the call and call the trace hook's `before`.
+   * 
+   * @param  method     The adjustment method.
+   * @param  partition  The index of the partition, `(size_t)-1` if none.
+   * @param  crtc       The index of the CRTC, `(size_t)-1` if none.
+   * @param  red        The size of the red gamma ramp, zero if none.
+   * @param  green      The size of the green gamma ramp, zero if none.
+   * @param  blue       The size of the blue gamma ramp, zero if none.
+   * @param  depth      The depth of the gamma ramps, zero if none.
+   */
+  void CallProbe::describe(int method, size_t partition, size_t crtc, size_t red, size_t green, size_t blue, signed depth)
+  {
+    this->event.operation = this->operation;
+    this->event.method = method;
+    this->event.partition = partition;
+    this->event.crtc = crtc;
+    this->event.ramp_sizes[0] = red;
+    this->event.ramp_sizes[1] = green;
+    this->event.ramp_sizes[2] = blue;
+    this->event.depth = depth;
+    this->event.result = 0;
+    this->event.duration_ns = 0;
+    this->event.start_ns = (uint64_t)(std::chrono::duration_cast<std::chrono::nanoseconds>
+				      (this->start.time_since_epoch()).count());
+    this->event.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+    this->hook->before(this->event);
+  }
+  
+  
+  /**
+   * Constructor.
+   * 
+   * @param  capacity  The number of events to keep.
+   */
+  ChromeTraceHook::ChromeTraceHook(size_t capacity) :
+    buffer(capacity == 0 ? 1 : capacity),
+    recorded(0),
+    mutex()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor.
+   */
+  ChromeTraceHook::~ChromeTraceHook()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Record a call.
+   * 
+   * @param  event  The call.
+   */
+  void ChromeTraceHook::after(const TraceEvent& event)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->buffer[this->recorded++ % this->buffer.size()] = event;
+  }
+  
+  /**
+   * Get the kept events, oldest first.
+   * 
+   * @return  The events.
+   */
+  std::vector<TraceEvent> ChromeTraceHook::events()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::vector<TraceEvent> rc;
+    uint64_t i, n = this->buffer.size();
+    i = this->recorded < n ? 0 : this->recorded - n;
+    for (; i < this->recorded; i++)
+      rc.push_back(this->buffer[i % n]);
+    return rc;
+  }
+  
+  /**
+   * Write a time in microseconds with nanosecond precision.
+   * 
+   * @param  output  The stream to write to.
+   * @param  ns      The time, in nanoseconds.
+   */
+  static void write_microseconds(std::ostream& output, uint64_t ns)
+  {
+    char fraction[4];
+    fraction[0] = (char)('0' + ns / 100 % 10);
+    fraction[1] = (char)('0' + ns / 10 % 10);
+    fraction[2] = (char)('0' + ns % 10);
+    fraction[3] = '\0';
+    output << ns / 1000 << '.' << fraction;
+  }
+  
+  /**
+   * Write the kept events as a JSON trace.
+   * 
+   * @param  output  The stream to write to.
+   */
+  void ChromeTraceHook::write_json(std::ostream& output)
+  {
+    std::vector<TraceEvent> list = this->events();
+    size_t i;
+    output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    for (i = 0; i < list.size(); i++)
+      {
+	const TraceEvent& e = list[i];
+	output << (i ? ",\n" : "\n")
+	       << "{\"name\": \"" << operation_name(e.operation) << "\""
+	       << ", \"cat\": \"libgamma\", \"ph\": \"X\", \"ts\": ";
+	write_microseconds(output, e.start_ns);
+	output << ", \"dur\": ";
+	write_microseconds(output, e.duration_ns);
+	output << ", \"pid\": " << getpid()
+	       << ", \"tid\": " << e.thread
+	       << ", \"args\": {\"method\": " << e.method
+	       << ", \"partition\": " << (long long int)(e.partition)
+	       << ", \"crtc\": " << (long long int)(e.crtc)
+	       << ", \"red_size\": " << e.ramp_sizes[0]
+	       << ", \"green_size\": " << e.ramp_sizes[1]
+	       << ", \"blue_size\": " << e.ramp_sizes[2]
+	       << ", \"depth\": " << e.depth
+	       << ", \"result\": " << e.result
+	       << "}}";
+      }
+    output << "\n]}" << std::endl;
+  }
+  
+  /**
+   * Remove all kept events.
+   */
+  void ChromeTraceHook::clear()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->recorded = 0;
+  }
+  
+}
+
@@ -0,0 +1,362 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_TRACE_HH
+#define LIBGAMMA_TRACE_HH
+
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "libgamma-stats.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * A description of a native call.
+   */
+  class TraceEvent
+  {
+  public:
+    /**
+     * The operation.
+     */
+    StatsOperation operation;
+    
+    /**
+     * The adjustment method.
+     */
+    int method;
+    
+    /**
+     * The index of the partition, `(size_t)-1`
+     * if the call is not for a partition.
+     */
+    size_t partition;
+    
+    /**
+     * The index of the CRTC, `(size_t)-1`
+     * if the call is not for a CRTC.
+     */
+    size_t crtc;
+    
+    /**
+     * The sizes of the red, green and blue gamma
+     * ramps, zero if the call has no gamma ramps.
+     */
+    size_t ramp_sizes[3];
+    
+    /**
+     * The depth of the gamma ramps, zero if
+     * the call has no gamma ramps.
+     */
+    signed depth;
+    
+    /**
+     * The return value of the native call,
+     * zero before the call has returned.
+     */
+    int result;
+    
+    /**
+     * When the call started, in nanoseconds
+     * on the monotonic clock.
+     */
+    uint64_t start_ns;
+    
+    /**
+     * How long the call took, in nanoseconds,
+     * zero before the call has returned.
+     */
+    uint64_t duration_ns;
+    
+    /**
+     * An identifier for the thread that made the call.
+     */
+    uint64_t thread;
+    
+  };
+  
+  
+  /**
+   * Interface for functions that are called around each native call.
+   */
+  class TraceHook
+  {
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~TraceHook();
+    
+    /**
+     * Called before a native call.
+     * 
+     * @param  event  The call, without `result` and `duration_ns`.
+     */
+    virtual void before(const TraceEvent& event);
+    
+    /**
+     * Called after a native call.
+     * 
+     * @param  event  The call.
+     */
+    virtual void after(const TraceEvent& event) = 0;
+    
+  };
+  
+  
+  /**
+   * The installed trace hook, `nullptr` if none.
+   * Use `set_trace_hook` to change it.
+   */
+  extern std::atomic<TraceHook*> trace_hook;
+  
+  /**
+   * Install a trace hook. The hook may be called from any thread
+   * and must remain valid until no native call that started
+   * whilst it was installed is running.
+   * 
+   * @param   hook  The hook, `nullptr` to remove the current hook.
+   * @return        The previously installed hook.
+   */
+  TraceHook* set_trace_hook(TraceHook* hook);
+  
+  /**
+   * Get the name of an operation.
+   * 
+   * @param   operation  The operation.
+   * @return             The name of the operation, for example "set_gamma".
+   */
+  const char* operation_name(StatsOperation operation) __attribute__((const));
+  
+  
+  /**
+   * A trace hook that keeps the latest events in a ring buffer
+   * and writes them in the Chrome trace event format, which can
+   * be loaded into chrome://tracing and Perfetto.
+   */
+  class ChromeTraceHook : public TraceHook
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  capacity  The number of events to keep.
+     */
+    ChromeTraceHook(size_t capacity = 65536);
+    
+    /**
+     * Destructor.
+     */
+    virtual ~ChromeTraceHook();
+    
+    /**
+     * Record a call.
+     * 
+     * @param  event  The call.
+     */
+    virtual void after(const TraceEvent& event);
+    
+    /**
+     * Get the kept events, oldest first.
+     * 
+     * @return  The events.
+     */
+    std::vector<TraceEvent> events();
+    
+    /**
+     * Write the kept events as a JSON trace.
+     * 
+     * @param  output  The stream to write to.
+     */
+    void write_json(std::ostream& output);
+    
+    /**
+     * Remove all kept events.
+     */
+    void clear();
+  
+  private:
+    /**
+     * The ring buffer.
+     */
+    std::vector<TraceEvent> buffer;
+    
+    /**
+     * The number of events that have been recorded.
+     */
+    uint64_t recorded;
+    
+    /**
+     * Guards `buffer` and `recorded`.
+     */
+    std::mutex mutex;
+    
+  };
+  
+  
+  /**
+   * Measures a native call, records it in the global
+   * counters and, optionally, in a CRTC's counters, and
+   * calls the trace hook if one is installed.
+   */
+  class CallProbe
+  {
+  public:
+    /**
+     * Constructor, starts the measurement.
+     * 
+     * @param  op     The operation.
+     * @param  local  The counters of the CRTC, or `nullptr`.
+     */
+    CallProbe(StatsOperation op, StatsCounters* local) :
+      operation(op),
+      counters(local),
+      hook(nullptr),
+      event(),
+      start(std::chrono::steady_clock::now())
+    {
+#ifndef LIBGAMMAMM_NO_TRACE
+      this->hook = trace_hook.load(std::memory_order_acquire);
+#endif
+    }
+    
+    /**
+     * Check whether a trace hook is installed, and
+     * therefore `describe` must be called.
+     * 
+     * @return  Whether the call is traced.
+     */
+    bool traced() const
+    {
+      return this->hook != nullptr;
+    }
+    
+    /**
+     * Describe the call and call the trace hook's `before`.
+     * 
+     * @param  method     The adjustment method.
+     * @param  partition  The index of the partition, `(size_t)-1` if none.
+     * @param  crtc       The index of the CRTC, `(size_t)-1` if none.
+     * @param  red        The size of the red gamma ramp, zero if none.
+     * @param  green      The size of the green gamma ramp, zero if none.
+     * @param  blue       The size of the blue gamma ramp, zero if none.
+     * @param  depth      The depth of the gamma ramps, zero if none.
+     */
+    void describe(int method, size_t partition, size_t crtc, size_t red, size_t green, size_t blue, signed depth);
+    
+    /**
+     * Stop the measurement and record the call.
+     * 
+     * @param  r  The return value of the native call, negative on failure.
+     */
+    void finish(int r)
+    {
+      std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - this->start;
+      uint64_t ns = (uint64_t)(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#ifndef LIBGAMMAMM_NO_STATS
+      global_stats_counters().record(this->operation, ns, r < 0);
+      if (this->counters != nullptr)
+	this->counters->record(this->operation, ns, r < 0);
+#endif
+      if (this->hook != nullptr)
+	{
+	  this->event.result = r;
+	  this->event.duration_ns = ns;
+	  this->hook->after(this->event);
+	}
+    }
+  
+  private:
+    /**
+     * The operation.
+     */
+    StatsOperation operation;
+    
+    /**
+     * The counters of the CRTC, or `nullptr`.
+     */
+    StatsCounters* counters;
+    
+    /**
+     * The trace hook, `nullptr` if the call is not traced.
+     */
+    TraceHook* hook;
+    
+    /**
+     * The description of the call, if it is traced.
+     */
+    TraceEvent event;
+    
+    /**
+     * When the call started.
+     */
+    std::chrono::steady_clock::time_point start;
+    
+  };
+  
+}
+
+
+/*
+ * Instrumentation of native calls. Define `LIBGAMMAMM_NO_STATS`
+ * to compile out the statistics and `LIBGAMMAMM_NO_TRACE` to
+ * compile out the trace hooks. `__LIBGAMMA_PROBE_BEGIN`,
+ * `__LIBGAMMA_PROBE_DESCRIBE` and `__LIBGAMMA_PROBE_END`
+ * must be used in the same scope. The arguments to
+ * `__LIBGAMMA_PROBE_DESCRIBE` are only evaluated if a
+ * trace hook is installed.
+ */
+#if !defined(LIBGAMMAMM_NO_STATS) || !defined(LIBGAMMAMM_NO_TRACE)
+# define __LIBGAMMA_PROBE_BEGIN(OPERATION, COUNTERS)			\
+  libgamma::CallProbe probe_(libgamma::OPERATION, COUNTERS)
+# define __LIBGAMMA_PROBE_END(R)			\
+  probe_.finish(R)
+#else
+# define __LIBGAMMA_PROBE_BEGIN(OPERATION, COUNTERS)  /* Do nothing. */
+# define __LIBGAMMA_PROBE_END(R)  /* Do nothing. */
+#endif
+#ifndef LIBGAMMAMM_NO_TRACE
+# define __LIBGAMMA_PROBE_DESCRIBE(...)		\
+  do						\
+    if (probe_.traced())			\
+      probe_.describe(__VA_ARGS__);		\
+  while (0)
+#else
+# define __LIBGAMMA_PROBE_DESCRIBE(...)  /* Do nothing. */
+#endif
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
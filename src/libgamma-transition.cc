@@ -0,0 +1,374 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma-transition.hh"
+
+#include "libgamma-convert.hh"
+#include "libgamma-facade.hh"
+
+#include <cerrno>
+
+#if defined(__GCC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+# define LIBGAMMA_HAVE_SSE2
+# include <emmintrin.h>
+#endif
+
+
+namespace libgamma
+{
+  /**
+   * Easing with constant speed.
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            `progress`.
+   */
+  double easing_linear(double progress)
+  {
+    return progress;
+  }
+  
+  /**
+   * Easing that accelerates from zero speed.
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            The position.
+   */
+  double easing_in(double progress)
+  {
+    return progress * progress;
+  }
+  
+  /**
+   * Easing that decelerates to zero speed.
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            The position.
+   */
+  double easing_out(double progress)
+  {
+    return progress * (2 - progress);
+  }
+  
+  /**
+   * Easing that accelerates from and decelerates
+   * to zero speed (smoothstep).
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            The position.
+   */
+  double easing_in_out(double progress)
+  {
+    return progress * progress * (3 - 2 * progress);
+  }
+  
+  
+  /**
+   * Calculate `origin + delta * position` for each element.
+   * 
+   * @param  origin    The values at position 0.
+   * @param  delta     The difference between the values at position 1 and 0.
+   * @param  position  The position.
+   * @param  output    Output parameter for the values.
+   * @param  n         The number of elements.
+   */
+  static void lerp(const double* origin, const double* delta, double position, double* output, size_t n)
+  {
+    size_t i = 0;
+#ifdef LIBGAMMA_HAVE_SSE2
+    __m128d t = _mm_set1_pd(position);
+    for (; i + 4 <= n; i += 4)
+      {
+	__m128d a = _mm_add_pd(_mm_loadu_pd(origin + i), _mm_mul_pd(_mm_loadu_pd(delta + i), t));
+	__m128d b = _mm_add_pd(_mm_loadu_pd(origin + i + 2), _mm_mul_pd(_mm_loadu_pd(delta + i + 2), t));
+	_mm_storeu_pd(output + i, a);
+	_mm_storeu_pd(output + i + 2, b);
+      }
+#endif
+    for (; i < n; i++)
+      output[i] = origin[i] + delta[i] * position;
+  }
+  
+  
+  /**
+   * Constructor.
+   * 
+   * @param  target  The CRTC to animate.
+   * @param  fps     The number of frames per second.
+   */
+  template <typename T>
+  GammaTransition<T>::GammaTransition(CRTC* target, double fps) :
+    crtc(target),
+    period(std::chrono::duration_cast<std::chrono::steady_clock::duration>
+	   (std::chrono::duration<double>(1 / fps))),
+    error(0),
+    frames(0),
+    origin(),
+    delta(),
+    current(),
+    sizes{0, 0, 0},
+    frame(),
+    begun(),
+    length(),
+    ease(easing_linear),
+    generation(0),
+    cancelled(false),
+    active(false),
+    completed(false),
+    thread(),
+    mutex(),
+    condition()
+  {
+    /* Do nothing. */
+  }
+  
+  /**
+   * Destructor, cancels the transition.
+   */
+  template <typename T>
+  GammaTransition<T>::~GammaTransition()
+  {
+    this->cancel();
+  }
+  
+  /**
+   * Start a transition, the current transition,
+   * if any, is cancelled first.
+   * 
+   * @param  from      The gamma ramps to start at.
+   * @param  to        The gamma ramps to end at, must have the same sizes as `from`.
+   * @param  duration  The duration of the transition, in seconds.
+   * @param  easing    The easing function.
+   */
+  template <typename T>
+  void GammaTransition<T>::start(const GammaRamps<T>* from, const GammaRamps<T>* to,
+				 double duration, Easing easing)
+  {
+    this->cancel();
+    
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->sizes[0] = from->red.size;
+    this->sizes[1] = from->green.size;
+    this->sizes[2] = from->blue.size;
+    this->frame = GammaRamps<T>();
+    gamma_ramps_allocate(&(this->frame), this->sizes[0], this->sizes[1], this->sizes[2]);
+    this->current.resize(this->sizes[0] + this->sizes[1] + this->sizes[2]);
+    convert_stops(from->red.ramp, this->current.data(), this->sizes[0]);
+    convert_stops(from->green.ramp, this->current.data() + this->sizes[0], this->sizes[1]);
+    convert_stops(from->blue.ramp, this->current.data() + this->sizes[0] + this->sizes[1], this->sizes[2]);
+    this->set_target(to, duration, easing);
+    
+    this->error = 0;
+    this->cancelled = false;
+    this->completed = false;
+    this->active = true;
+    this->thread = std::thread(&GammaTransition<T>::run, this);
+  }
+  
+  /**
+   * Change the end of the transition without stopping it.
+   * The transition continues from the ramps currently being
+   * shown, and the duration starts over. If no transition is
+   * running, one is started from the last applied frame.
+   * 
+   * @param  to        The gamma ramps to end at, must have the same sizes
+   *                   as the ramps the transition was started with.
+   * @param  duration  The duration of the new transition, in seconds.
+   * @param  easing    The easing function.
+   */
+  template <typename T>
+  void GammaTransition<T>::retarget(const GammaRamps<T>* to, double duration, Easing easing)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->current.empty())
+	throw create_error(EINVAL);
+      this->set_target(to, duration, easing);
+      if (this->active)
+	{
+	  this->condition.notify_all();
+	  return;
+	}
+    }
+    
+    if (this->thread.joinable())
+      this->thread.join();
+    
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->error = 0;
+    this->cancelled = false;
+    this->completed = false;
+    this->active = true;
+    this->thread = std::thread(&GammaTransition<T>::run, this);
+  }
+  
+  /**
+   * Stop the transition, leaving the last applied frame on the CRTC.
+   */
+  template <typename T>
+  void GammaTransition<T>::cancel()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->cancelled = true;
+      this->condition.notify_all();
+    }
+    if (this->thread.joinable())
+      this->thread.join();
+  }
+  
+  /**
+   * Wait until the transition has finished or been cancelled.
+   * 
+   * @return  Whether the transition reached its end.
+   */
+  template <typename T>
+  bool GammaTransition<T>::wait()
+  {
+    if (this->thread.joinable())
+      this->thread.join();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->completed;
+  }
+  
+  /**
+   * Check whether a transition is running.
+   * 
+   * @return  Whether a transition is running.
+   */
+  template <typename T>
+  bool GammaTransition<T>::running()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->active;
+  }
+  
+  /**
+   * Set the end of the transition and restart its clock,
+   * must be called with `mutex` locked.
+   * 
+   * @param  to        The gamma ramps to end at.
+   * @param  duration  The duration, in seconds.
+   * @param  easing    The easing function.
+   */
+  template <typename T>
+  void GammaTransition<T>::set_target(const GammaRamps<T>* to, double duration, Easing easing)
+  {
+    size_t i, n = this->current.size();
+    if ((to->red.size != this->sizes[0]) || (to->green.size != this->sizes[1]) || (to->blue.size != this->sizes[2]))
+      throw create_error(EINVAL);
+    this->origin = this->current;
+    this->delta.resize(n);
+    convert_stops(to->red.ramp, this->delta.data(), this->sizes[0]);
+    convert_stops(to->green.ramp, this->delta.data() + this->sizes[0], this->sizes[1]);
+    convert_stops(to->blue.ramp, this->delta.data() + this->sizes[0] + this->sizes[1], this->sizes[2]);
+    for (i = 0; i < n; i++)
+      this->delta[i] -= this->origin[i];
+    this->begun = std::chrono::steady_clock::now();
+    this->length = std::chrono::duration_cast<std::chrono::steady_clock::duration>
+      (std::chrono::duration<double>(duration < 0 ? 0 : duration));
+    this->ease = easing == nullptr ? easing_linear : easing;
+    this->generation++;
+  }
+  
+  /**
+   * Calculate the frame for a position between the
+   * start and the end, into `current` and `frame`,
+   * must be called with `mutex` locked.
+   * 
+   * @param  position  The eased position, in [0, 1].
+   */
+  template <typename T>
+  void GammaTransition<T>::interpolate(double position)
+  {
+    double* values = this->current.data();
+    lerp(this->origin.data(), this->delta.data(), position, values, this->current.size());
+    convert_stops(values, this->frame.red.ramp, this->sizes[0]);
+    convert_stops(values + this->sizes[0], this->frame.green.ramp, this->sizes[1]);
+    convert_stops(values + this->sizes[0] + this->sizes[1], this->frame.blue.ramp, this->sizes[2]);
+  }
+  
+  /**
+   * The function that runs on the thread.
+   */
+  template <typename T>
+  void GammaTransition<T>::run()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    std::chrono::steady_clock::time_point now, next = std::chrono::steady_clock::now();
+    uint64_t generation_;
+    double progress;
+    
+    while (!(this->cancelled))
+      {
+	now = std::chrono::steady_clock::now();
+	if ((this->length.count() <= 0) || (now - this->begun >= this->length))
+	  progress = 1;
+	else
+	  progress = std::chrono::duration<double>(now - this->begun).count()
+	    / std::chrono::duration<double>(this->length).count();
+	this->interpolate(this->ease(progress));
+	generation_ = this->generation;
+	
+	lock.unlock();
+	try
+	  {
+	    this->crtc->set_gamma(&(this->frame));
+	  }
+	catch (const LibgammaException& e)
+	  {
+	    lock.lock();
+	    this->error = e.error_code;
+	    break;
+	  }
+	lock.lock();
+	this->frames++;
+	
+	if ((progress >= 1) && (generation_ == this->generation))
+	  {
+	    this->completed = true;
+	    break;
+	  }
+	
+	/* Skip frames that were missed rather than shifting the schedule. */
+	now = std::chrono::steady_clock::now();
+	do
+	  next += this->period;
+	while (next <= now);
+	this->condition.wait_until(lock, next, [this, generation_]
+				   {
+				     return this->cancelled || (generation_ != this->generation);
+				   });
+      }
+    
+    this->active = false;
+  }
+  
+  
+#define __LIBGAMMA_TRANSITION(T)		\
+  template class GammaTransition<T>
+  
+  __LIBGAMMA_TRANSITION(uint8_t);
+  __LIBGAMMA_TRANSITION(uint16_t);
+  __LIBGAMMA_TRANSITION(uint32_t);
+  __LIBGAMMA_TRANSITION(uint64_t);
+  __LIBGAMMA_TRANSITION(float);
+  __LIBGAMMA_TRANSITION(double);
+  
+#undef __LIBGAMMA_TRANSITION
+
+}
+
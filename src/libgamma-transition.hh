@@ -0,0 +1,299 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBGAMMA_TRANSITION_HH
+#define LIBGAMMA_TRANSITION_HH
+
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "libgamma-method.hh"
+
+
+#ifndef __GCC__
+# define __attribute__(X) /* emtpy */
+#endif
+
+
+
+namespace libgamma
+{
+  /**
+   * An easing function, maps the progress of a
+   * transition, in [0, 1], to the position between
+   * the start and the end ramps, 0 at the start
+   * and 1 at the end.
+   */
+  typedef double (*Easing)(double progress);
+  
+  /**
+   * Easing with constant speed.
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            `progress`.
+   */
+  double easing_linear(double progress) __attribute__((const));
+  
+  /**
+   * Easing that accelerates from zero speed.
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            The position.
+   */
+  double easing_in(double progress) __attribute__((const));
+  
+  /**
+   * Easing that decelerates to zero speed.
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            The position.
+   */
+  double easing_out(double progress) __attribute__((const));
+  
+  /**
+   * Easing that accelerates from and decelerates
+   * to zero speed (smoothstep).
+   * 
+   * @param   progress  The progress, in [0, 1].
+   * @return            The position.
+   */
+  double easing_in_out(double progress) __attribute__((const));
+  
+  
+  /**
+   * Animates the gamma ramps of a CRTC from one set of
+   * gamma ramps to another, on a thread of its own.
+   * 
+   * Frames are paced against the monotonic clock at a fixed
+   * rate; if a frame is late, later frames are not shifted
+   * and missed frames are skipped, so the transition ends
+   * on time. The CRTC must not be used by anyone else while
+   * a transition is running.
+   */
+  template <typename T>
+  class GammaTransition
+  {
+  public:
+    /**
+     * Constructor.
+     * 
+     * @param  target  The CRTC to animate.
+     * @param  fps     The number of frames per second.
+     */
+    GammaTransition(CRTC* target, double fps = 60);
+    
+    /**
+     * Destructor, cancels the transition.
+     */
+    ~GammaTransition();
+    
+    /**
+     * Start a transition, the current transition,
+     * if any, is cancelled first.
+     * 
+     * @param  from      The gamma ramps to start at.
+     * @param  to        The gamma ramps to end at, must have the same sizes as `from`.
+     * @param  duration  The duration of the transition, in seconds.
+     * @param  easing    The easing function.
+     */
+    void start(const GammaRamps<T>* from, const GammaRamps<T>* to,
+	       double duration, Easing easing = easing_linear);
+    
+    /**
+     * Change the end of the transition without stopping it.
+     * The transition continues from the ramps currently being
+     * shown, and the duration starts over. If no transition is
+     * running, one is started from the last applied frame.
+     * 
+     * @param  to        The gamma ramps to end at, must have the same sizes
+     *                   as the ramps the transition was started with.
+     * @param  duration  The duration of the new transition, in seconds.
+     * @param  easing    The easing function.
+     */
+    void retarget(const GammaRamps<T>* to, double duration, Easing easing = easing_linear);
+    
+    /**
+     * Stop the transition, leaving the last applied frame on the CRTC.
+     */
+    void cancel();
+    
+    /**
+     * Wait until the transition has finished or been cancelled.
+     * 
+     * @return  Whether the transition reached its end.
+     */
+    bool wait();
+    
+    /**
+     * Check whether a transition is running.
+     * 
+     * @return  Whether a transition is running.
+     */
+    bool running();
+    
+    
+    
+    /**
+     * The CRTC that is animated.
+     */
+    CRTC* crtc;
+    
+    /**
+     * The time between frames.
+     */
+    std::chrono::steady_clock::duration period;
+    
+    /**
+     * The error code from the last failed `CRTC::set_gamma`,
+     * which stops the transition, zero if none has failed.
+     */
+    int error;
+    
+    /**
+     * The number of frames that have been applied.
+     */
+    uint64_t frames;
+  
+  private:
+    /**
+     * Copy constructor, deleted.
+     */
+    GammaTransition(const GammaTransition<T>&) = delete;
+    
+    /**
+     * Copy operator, deleted.
+     */
+    GammaTransition<T>& operator =(const GammaTransition<T>&) = delete;
+    
+    /**
+     * Set the end of the transition and restart its clock,
+     * must be called with `mutex` locked.
+     * 
+     * @param  to        The gamma ramps to end at.
+     * @param  duration  The duration, in seconds.
+     * @param  easing    The easing function.
+     */
+    void set_target(const GammaRamps<T>* to, double duration, Easing easing);
+    
+    /**
+     * Calculate the frame for a position between the
+     * start and the end, into `current` and `frame`,
+     * must be called with `mutex` locked.
+     * 
+     * @param  position  The eased position, in [0, 1].
+     */
+    void interpolate(double position);
+    
+    /**
+     * The function that runs on the thread.
+     */
+    void run();
+    
+    
+    
+    /**
+     * The start of the transition, in double precision, for
+     * each channel, with the channels after each other.
+     */
+    std::vector<double> origin;
+    
+    /**
+     * The end minus the start, layout as `origin`.
+     */
+    std::vector<double> delta;
+    
+    /**
+     * The values of the last calculated frame, layout as `origin`.
+     */
+    std::vector<double> current;
+    
+    /**
+     * The sizes of the red, green and blue ramps.
+     */
+    size_t sizes[3];
+    
+    /**
+     * The frame that is applied to the CRTC.
+     */
+    GammaRamps<T> frame;
+    
+    /**
+     * When the transition, or its last retargeting, started.
+     */
+    std::chrono::steady_clock::time_point begun;
+    
+    /**
+     * The duration of the transition.
+     */
+    std::chrono::steady_clock::duration length;
+    
+    /**
+     * The easing function.
+     */
+    Easing ease;
+    
+    /**
+     * Incremented each time the transition is retargeted.
+     */
+    uint64_t generation;
+    
+    /**
+     * Whether the thread shall stop.
+     */
+    bool cancelled;
+    
+    /**
+     * Whether the thread is running.
+     */
+    bool active;
+    
+    /**
+     * Whether the last transition reached its end.
+     */
+    bool completed;
+    
+    /**
+     * The thread that applies the frames.
+     */
+    std::thread thread;
+    
+    /**
+     * Guards the state shared with the thread.
+     */
+    std::mutex mutex;
+    
+    /**
+     * Wakes the thread when the transition is
+     * cancelled or retargeted.
+     */
+    std::condition_variable condition;
+    
+  };
+  
+}
+
+
+#ifndef __GCC__
+# undef __attribute__
+#endif
+
+#endif
+
@@ -22,6 +22,25 @@
 #include "libgamma-error.hh"
 #include "libgamma-method.hh"
 #include "libgamma-facade.hh"
+#include "libgamma-convert.hh"
+#include "libgamma-pipeline.hh"
+#include "libgamma-generate.hh"
+#include "libgamma-arena.hh"
+#include "libgamma-hash.hh"
+#include "libgamma-elision.hh"
+#include "libgamma-transition.hh"
+#include "libgamma-executor.hh"
+#include "libgamma-batch.hh"
+#include "libgamma-async.hh"
+#include "libgamma-mailbox.hh"
+#include "libgamma-stats.hh"
+#include "libgamma-trace.hh"
+#include "libgamma-edid.hh"
+#include "libgamma-calibration.hh"
+#include "libgamma-topology.hh"
+#include "libgamma-method-table.hh"
+#include "libgamma-context.hh"
+#include "libgamma-site-pool.hh"
 
 
 #endif
@@ -0,0 +1,289 @@
+/**
+ * libgammamm -- C++ wrapper for libgamma
+ * Copyright (C) 2014  Mattias Andrée (maandree@member.fsf.org)
+ * 
+ * This library is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "libgamma.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+
+/*
+ * Stress test for the thread-safety of sites, partitions and
+ * CRTC:s, run against the dummy adjustment method so that no
+ * display is needed. A number of threads call `set_gamma`,
+ * `get_gamma`, `information`, `cached_information`,
+ * `invalidate_information` and `elide_unchanged` on randomly
+ * chosen CRTC:s of all partitions, and `Site::restore`, at the
+ * same time. Each thread sets gamma ramps where all stops have
+ * the same value, so a gamma ramp that is read back with
+ * different values, and that is not the gamma ramp that
+ * `Site::restore` sets, was torn by an unserialised call.
+ * 
+ * Usage: stress [-t threads] [-n iterations]
+ */
+
+
+/**
+ * The number of threads.
+ */
+static size_t threads = 8;
+
+/**
+ * The number of operations per thread.
+ */
+static size_t iterations = 20000;
+
+/**
+ * The site.
+ */
+static libgamma::Site* site;
+
+/**
+ * All CRTC:s, of all partitions.
+ */
+static std::vector<libgamma::CRTC*> crtcs;
+
+/**
+ * The gamma ramps of each CRTC, by index in
+ * `crtcs`, after `Site::restore` has been called.
+ */
+static std::vector<libgamma::GammaRamps<uint16_t>*> restored;
+
+/**
+ * The number of failed checks and unexpected errors.
+ */
+static std::atomic<size_t> failures(0);
+
+
+/**
+ * Check that all stops in a gamma ramp have the same value.
+ * 
+ * @param   ramps  The gamma ramps.
+ * @return         Whether the gamma ramps are uniform.
+ */
+static bool uniform(const libgamma::GammaRamps<uint16_t>* ramps) __attribute__((pure));
+static bool uniform(const libgamma::GammaRamps<uint16_t>* ramps)
+{
+  uint16_t value = ramps->red.ramp[0];
+  size_t i;
+  for (i = 0; i < ramps->red.size; i++)
+    if (ramps->red.ramp[i] != value)
+      return false;
+  for (i = 0; i < ramps->green.size; i++)
+    if (ramps->green.ramp[i] != value)
+      return false;
+  for (i = 0; i < ramps->blue.size; i++)
+    if (ramps->blue.ramp[i] != value)
+      return false;
+  return true;
+}
+
+
+/**
+ * Check whether two gamma ramps are identical.
+ * 
+ * @param   a  One of the gamma ramps.
+ * @param   b  The other gamma ramps, with the same sizes as `a`.
+ * @return     Whether the gamma ramps are identical.
+ */
+static bool identical(const libgamma::GammaRamps<uint16_t>* a,
+		      const libgamma::GammaRamps<uint16_t>* b) __attribute__((pure));
+static bool identical(const libgamma::GammaRamps<uint16_t>* a,
+		      const libgamma::GammaRamps<uint16_t>* b)
+{
+  return !memcmp(a->red.ramp, b->red.ramp, a->red.size * sizeof(uint16_t)) &&
+    !memcmp(a->green.ramp, b->green.ramp, a->green.size * sizeof(uint16_t)) &&
+    !memcmp(a->blue.ramp, b->blue.ramp, a->blue.size * sizeof(uint16_t));
+}
+
+
+/**
+ * Fill gamma ramps with one value.
+ * 
+ * @param  ramps  The gamma ramps.
+ * @param  value  The value of all stops.
+ */
+static void fill(libgamma::GammaRamps<uint16_t>* ramps, uint16_t value)
+{
+  size_t i;
+  for (i = 0; i < ramps->red.size; i++)
+    ramps->red.ramp[i] = value;
+  for (i = 0; i < ramps->green.size; i++)
+    ramps->green.ramp[i] = value;
+  for (i = 0; i < ramps->blue.size; i++)
+    ramps->blue.ramp[i] = value;
+}
+
+
+/**
+ * The function that runs on each thread.
+ * 
+ * @param  index  The index of the thread.
+ */
+static void worker(size_t index)
+{
+  libgamma::CRTCInformation info;
+  libgamma::GammaRamps<uint16_t>* ramps = nullptr;
+  unsigned int seed = (unsigned int)(index * 2654435761U + 1);
+  libgamma::CRTC* crtc;
+  size_t i, index_of_crtc;
+  int r;
+  
+  for (i = 0; i < iterations; i++)
+    {
+      index_of_crtc = (size_t)rand_r(&seed) % crtcs.size();
+      crtc = crtcs[index_of_crtc];
+      crtc->cached_information(&info, LIBGAMMA_CRTC_INFO_GAMMA_SIZE);
+      if ((ramps == nullptr) || (ramps->red.size != info.red_gamma_size) ||
+	  (ramps->green.size != info.green_gamma_size) || (ramps->blue.size != info.blue_gamma_size))
+	{
+	  delete ramps;
+	  ramps = libgamma::gamma_ramps16_create(info.red_gamma_size, info.green_gamma_size,
+						 info.blue_gamma_size);
+	}
+      
+      switch (rand_r(&seed) % 16)
+	{
+	case 0:
+	case 1:
+	case 2:
+	case 3:
+	case 4:
+	case 5:
+	  fill(ramps, (uint16_t)(index * 1000 + i % 1000));
+	  r = crtc->try_set_gamma(ramps);
+	  break;
+	case 6:
+	case 7:
+	case 8:
+	case 9:
+	  r = crtc->try_get_gamma(ramps);
+	  if ((r == 0) && !uniform(ramps) && !identical(ramps, restored[index_of_crtc]))
+	    {
+	      std::cerr << "stress: torn gamma ramps read from CRTC " << crtc->crtc
+			<< " of partition " << crtc->partition->partition << std::endl;
+	      failures++;
+	    }
+	  break;
+	case 10:
+	case 11:
+	  crtc->information(&info, ~0);
+	  r = 0;
+	  break;
+	case 12:
+	  crtc->invalidate_information();
+	  r = 0;
+	  break;
+	case 13:
+	  r = site->try_restore();
+	  break;
+	default:
+	  crtc->elide_unchanged(rand_r(&seed) % 2 == 0);
+	  r = 0;
+	  break;
+	}
+      if (r != 0)
+	{
+	  libgamma::perror("stress", r);
+	  failures++;
+	}
+    }
+  
+  delete ramps;
+}
+
+
+int main(int argc, char* argv[])
+{
+  libgamma::GammaRamps<uint16_t>* ramps;
+  libgamma::CRTCInformation info;
+  std::vector<libgamma::Partition*> partitions;
+  std::vector<std::thread> workers;
+  size_t p, c;
+  int i;
+  
+  for (i = 1; i < argc; i++)
+    if (!strcmp(argv[i], "-t") && (i + 1 < argc))
+      threads = (size_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "-n") && (i + 1 < argc))
+      iterations = (size_t)atol(argv[++i]);
+    else
+      {
+	std::cerr << "Usage: " << argv[0] << " [-t threads] [-n iterations]" << std::endl;
+	return 1;
+      }
+  if (threads == 0)
+    threads = 1;
+  
+  if (!libgamma::is_method_available(LIBGAMMA_METHOD_DUMMY))
+    {
+      std::cerr << argv[0] << ": the dummy adjustment method is not available" << std::endl;
+      return 1;
+    }
+  
+  site = new libgamma::Site(LIBGAMMA_METHOD_DUMMY);
+  for (p = 0; p < site->partitions_available; p++)
+    {
+      partitions.push_back(new libgamma::Partition(site, p));
+      for (c = 0; c < partitions.back()->crtcs_available; c++)
+	crtcs.push_back(new libgamma::CRTC(partitions.back(), c));
+    }
+  if (crtcs.empty())
+    {
+      std::cerr << argv[0] << ": the dummy adjustment method has no CRTC:s" << std::endl;
+      return 1;
+    }
+  
+  /* Remember what `Site::restore` sets, and then start
+   * from uniform gamma ramps, which that need not be. */
+  site->restore();
+  for (libgamma::CRTC* crtc : crtcs)
+    {
+      crtc->information(&info, LIBGAMMA_CRTC_INFO_GAMMA_SIZE);
+      ramps = libgamma::gamma_ramps16_create(info.red_gamma_size, info.green_gamma_size,
+					     info.blue_gamma_size);
+      crtc->get_gamma(ramps);
+      restored.push_back(ramps);
+      ramps = libgamma::gamma_ramps16_create(info.red_gamma_size, info.green_gamma_size,
+					     info.blue_gamma_size);
+      fill(ramps, 0);
+      crtc->set_gamma(ramps);
+      delete ramps;
+    }
+  
+  for (p = 0; p < threads; p++)
+    workers.push_back(std::thread(worker, p));
+  for (std::thread& thread : workers)
+    thread.join();
+  
+  for (libgamma::CRTC* crtc : crtcs)
+    delete crtc;
+  for (libgamma::GammaRamps<uint16_t>* ramps_ : restored)
+    delete ramps_;
+  for (libgamma::Partition* partition : partitions)
+    delete partition;
+  delete site;
+  
+  std::cout << threads << " threads, " << iterations << " operations each, "
+	    << crtcs.size() << " CRTC:s, " << failures.load() << " failures" << std::endl;
+  return failures.load() == 0 ? 0 : 1;
+}
+
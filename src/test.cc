@@ -30,6 +30,7 @@ int main(void)
   libgamma::CRTCInformation info;
   libgamma::MethodCapabilities caps;
   libgamma::GammaRamps<uint16_t>* ramps;
+  libgamma::GammaRamps<double>* dramps;
   int method;
   size_t i;
   
@@ -231,6 +232,16 @@ int main(void)
   
   crtc->set_gamma(ramps);
   
+  dramps = libgamma::gamma_rampsd_create(ramps->red.size, ramps->green.size, ramps->blue.size);
+  libgamma::convert_gamma_ramps(ramps, dramps);
+  libgamma::convert_gamma_ramps(dramps, ramps);
+  for (i = 0; i < ramps->red.size; i++)
+    if (ramps->red[i] != saved_red[i])
+      break;
+  std::cout << (i == ramps->red.size ? "conversion ok" : "conversion failed") << std::endl;
+  std::cout << std::endl;
+  delete dramps;
+  
   delete [] saved_red;
   delete [] saved_green;
   delete [] saved_blue;